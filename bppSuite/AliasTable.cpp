@@ -0,0 +1,121 @@
+//
+// File: AliasTable.cpp
+// Created by: Bio++ Development Team
+// Created on: Oct Sun 18 2026
+//
+
+/*
+Copyright or © or Copr. Bio++ Development Team
+
+This software is a computer program whose purpose is to simulate sequence
+data according to a phylogenetic tree and an evolutionary model.
+
+This software is governed by the CeCILL  license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+*/
+
+#include "AliasTable.h"
+
+// From bpp-core:
+#include <Bpp/Exceptions.h>
+#include <Bpp/Numeric/Random/RandomTools.h>
+#include <Bpp/Text/TextTools.h>
+
+using namespace bpp;
+using namespace std;
+
+AliasTable::AliasTable(const vector<double>& weights) :
+  prob_(weights.size()),
+  alias_(weights.size())
+{
+  size_t n = weights.size();
+  if (n == 0)
+    throw Exception("AliasTable: empty distribution.");
+
+  double sum = 0;
+  for (size_t i = 0; i < n; ++i)
+  {
+    if (weights[i] < 0)
+      throw Exception("AliasTable: negative weight " + TextTools::toString(weights[i]) + " for outcome " + TextTools::toString(i) + ".");
+    sum += weights[i];
+  }
+  if (sum <= 0)
+    throw Exception("AliasTable: all weights are null.");
+
+  // Vose's algorithm: scaled weights are split in small (<1) and large (>=1)
+  // ones, and each small one is topped up with a share of a large one.
+  vector<double> scaled(n);
+  vector<size_t> small, large;
+  for (size_t i = 0; i < n; ++i)
+  {
+    scaled[i] = weights[i] * static_cast<double>(n) / sum;
+    if (scaled[i] < 1.)
+      small.push_back(i);
+    else
+      large.push_back(i);
+  }
+
+  while (!small.empty() && !large.empty())
+  {
+    size_t l = small.back();
+    small.pop_back();
+    size_t g = large.back();
+    large.pop_back();
+    prob_[l] = scaled[l];
+    alias_[l] = g;
+    scaled[g] = (scaled[g] + scaled[l]) - 1.;
+    if (scaled[g] < 1.)
+      small.push_back(g);
+    else
+      large.push_back(g);
+  }
+
+  // Remaining entries are full, up to rounding errors:
+  for (auto i : large)
+  {
+    prob_[i] = 1.;
+    alias_[i] = i;
+  }
+  for (auto i : small)
+  {
+    prob_[i] = 1.;
+    alias_[i] = i;
+  }
+}
+
+size_t AliasTable::pick() const
+{
+  return pick(RandomTools::giveRandomNumberBetweenZeroAndEntry(1.));
+}
+
+size_t AliasTable::pick(double u) const
+{
+  double x = u * static_cast<double>(prob_.size());
+  size_t i = static_cast<size_t>(x);
+  if (i >= prob_.size())
+    i = prob_.size() - 1;
+  return (x - static_cast<double>(i) < prob_[i]) ? i : alias_[i];
+}
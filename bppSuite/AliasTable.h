@@ -0,0 +1,90 @@
+//
+// File: AliasTable.h
+// Created by: Bio++ Development Team
+// Created on: Oct Sun 18 2026
+//
+
+/*
+Copyright or © or Copr. Bio++ Development Team
+
+This software is a computer program whose purpose is to simulate sequence
+data according to a phylogenetic tree and an evolutionary model.
+
+This software is governed by the CeCILL  license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+*/
+
+#ifndef BPPSUITE_ALIASTABLE_H
+#define BPPSUITE_ALIASTABLE_H
+
+// From the STL:
+#include <vector>
+#include <cstddef>
+
+namespace bpp
+{
+/**
+ * @brief Walker's alias table for sampling from a discrete distribution.
+ *
+ * The table is built once in O(n) using Vose's algorithm, after which each
+ * draw takes constant time, whatever the number of outcomes. This pays off
+ * when the same distribution is sampled many times, like the distribution of
+ * root states at the sites of a simulated alignment.
+ *
+ * Weights do not need to be normalized.
+ */
+class AliasTable
+{
+private:
+  std::vector<double> prob_;
+  std::vector<size_t> alias_;
+
+public:
+  AliasTable() : prob_(), alias_() {}
+
+  /**
+   * @param weights Non-negative weights of the outcomes, with a positive sum.
+   * @throw Exception if weights are empty, negative or all zero.
+   */
+  AliasTable(const std::vector<double>& weights);
+
+public:
+  size_t getNumberOfOutcomes() const { return prob_.size(); }
+
+  /**
+   * @return An outcome index drawn with the default random generator.
+   */
+  size_t pick() const;
+
+  /**
+   * @return The outcome index corresponding to a given uniform deviate.
+   * @param u A random number in [0, 1).
+   */
+  size_t pick(double u) const;
+};
+} // end of namespace bpp.
+
+#endif // BPPSUITE_ALIASTABLE_H
@@ -0,0 +1,430 @@
+//
+// File: BipartitionCounter.cpp
+// Created by: Bio++ Development Team
+// Created on: Oct Sun 18 2026
+//
+
+/*
+Copyright or © or Copr. Bio++ Development Team
+
+This software is a computer program whose purpose is to estimate
+phylogenies and evolutionary parameters from a dataset according to
+the maximum likelihood principle.
+
+This software is governed by the CeCILL  license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+*/
+
+#include "BipartitionCounter.h"
+
+// From the STL:
+#include <algorithm>
+#include <bitset>
+#include <cmath>
+#include <limits>
+
+// From bpp-core:
+#include <Bpp/Exceptions.h>
+#include <Bpp/Numeric/Number.h>
+
+// From bpp-phyl:
+#include <Bpp/Phyl/Tree/TreeTools.h>
+
+using namespace bpp;
+using namespace std;
+
+const size_t BipartitionCounter::NONE = numeric_limits<size_t>::max();
+
+/******************************************************************************/
+
+size_t BipartitionCounter::SplitHash::operator()(const Split& split) const
+{
+  return hash_(split.data(), split.size());
+}
+
+/******************************************************************************/
+
+void BipartitionCounter::LengthStatistics::add(double length)
+{
+  number++;
+  double delta = length - mean;
+  mean += delta / static_cast<double>(number);
+  sumOfSquares += delta * (length - mean);
+}
+
+void BipartitionCounter::LengthStatistics::merge(const LengthStatistics& statistics)
+{
+  if (statistics.number == 0)
+    return;
+  double n1 = static_cast<double>(number);
+  double n2 = static_cast<double>(statistics.number);
+  double delta = statistics.mean - mean;
+  number += statistics.number;
+  mean += delta * n2 / (n1 + n2);
+  sumOfSquares += statistics.sumOfSquares + delta * delta * n1 * n2 / (n1 + n2);
+}
+
+/******************************************************************************/
+
+size_t BipartitionCounter::hash_(const uint64_t* words, size_t nbWords)
+{
+  // 64-bit FNV-1a over the words:
+  uint64_t h = 14695981039346656037ULL;
+  for (size_t w = 0; w < nbWords; ++w)
+  {
+    h ^= words[w];
+    h *= 1099511628211ULL;
+  }
+  return static_cast<size_t>(h ^ (h >> 32));
+}
+
+/******************************************************************************/
+
+BipartitionCounter::BipartitionCounter(const vector<string>& taxa) :
+  taxa_(taxa),
+  taxonIndex_(),
+  nbWords_((taxa.size() + 63) / 64),
+  splits_(),
+  counts_(),
+  lengths_(),
+  table_(64, NONE),
+  leafLengths_(taxa.size()),
+  nbTrees_(0)
+{
+  for (size_t i = 0; i < taxa_.size(); ++i)
+  {
+    if (!taxonIndex_.insert(make_pair(taxa_[i], i)).second)
+      throw Exception("BipartitionCounter: duplicated taxon name '" + taxa_[i] + "'.");
+  }
+}
+
+/******************************************************************************/
+
+size_t BipartitionCounter::findSlot_(const uint64_t* words) const
+{
+  size_t mask = table_.size() - 1;
+  for (size_t slot = hash_(words, nbWords_) & mask; ; slot = (slot + 1) & mask)
+  {
+    size_t index = table_[slot];
+    if (index == NONE || equal(words, words + nbWords_, splits_.begin() + static_cast<ptrdiff_t>(index * nbWords_)))
+      return slot;
+  }
+}
+
+/******************************************************************************/
+
+size_t BipartitionCounter::insert_(const uint64_t* words)
+{
+  size_t slot = findSlot_(words);
+  if (table_[slot] != NONE)
+    return table_[slot];
+
+  size_t index = counts_.size();
+  splits_.insert(splits_.end(), words, words + nbWords_);
+  counts_.push_back(0);
+  lengths_.push_back(LengthStatistics());
+  table_[slot] = index;
+
+  // Keep the table at most half full:
+  if (2 * counts_.size() > table_.size())
+  {
+    table_.assign(2 * table_.size(), NONE);
+    for (size_t i = 0; i < counts_.size(); ++i)
+      table_[findSlot_(&splits_[i * nbWords_])] = i;
+  }
+  return index;
+}
+
+/******************************************************************************/
+
+size_t BipartitionCounter::getCount(const Split& split) const
+{
+  size_t index = table_[findSlot_(split.data())];
+  return index == NONE ? 0 : counts_[index];
+}
+
+/******************************************************************************/
+
+BipartitionCounter::LengthStatistics BipartitionCounter::getBranchLengths(const Split& split) const
+{
+  size_t index = table_[findSlot_(split.data())];
+  return index == NONE ? LengthStatistics() : lengths_[index];
+}
+
+/******************************************************************************/
+
+vector<pair<int, BipartitionCounter::Split>> BipartitionCounter::getSplits(const Tree& tree) const
+{
+  size_t nbTaxa = taxa_.size();
+  if (tree.getNumberOfLeaves() != nbTaxa)
+    throw Exception("BipartitionCounter::getSplits: the tree does not have " + to_string(nbTaxa) + " leaves.");
+
+  // Nodes in breadth-first order, without recursion so that deep trees are
+  // fine. The sons of the k-th node are at positions firstSons[k] to
+  // firstSons[k + 1] - 1.
+  int rootId = tree.getRootId();
+  vector<int> order(1, rootId);
+  vector<size_t> firstSons;
+  for (size_t k = 0; k < order.size(); ++k)
+  {
+    firstSons.push_back(order.size());
+    for (int sonId : tree.getSonsId(order[k]))
+      order.push_back(sonId);
+  }
+  firstSons.push_back(order.size());
+
+  // Leaf sets, bottom-up, in a single buffer:
+  vector<uint64_t> sets(order.size() * nbWords_, 0);
+  vector<size_t> nbLeaves(order.size(), 0);
+  vector<pair<int, Split>> splits;
+  for (size_t k = order.size(); k > 0; --k)
+  {
+    int nodeId = order[k - 1];
+    uint64_t* set = &sets[(k - 1) * nbWords_];
+    if (firstSons[k - 1] == firstSons[k])
+    {
+      auto it = taxonIndex_.find(tree.getNodeName(nodeId));
+      if (it == taxonIndex_.end())
+        throw Exception("BipartitionCounter::getSplits: unknown leaf '" + tree.getNodeName(nodeId) + "'.");
+      set[it->second / 64] |= uint64_t(1) << (it->second % 64);
+      nbLeaves[k - 1] = 1;
+    }
+    else
+    {
+      for (size_t son = firstSons[k - 1]; son < firstSons[k]; ++son)
+      {
+        const uint64_t* sonSet = &sets[son * nbWords_];
+        for (size_t w = 0; w < nbWords_; ++w)
+          set[w] |= sonSet[w];
+        nbLeaves[k - 1] += nbLeaves[son];
+      }
+    }
+    if (k == 1 || nbLeaves[k - 1] <= 1 || nbLeaves[k - 1] >= nbTaxa - 1)
+      continue;
+
+    Split split(set, set + nbWords_);
+    if (split[0] & 1)
+    {
+      for (auto& word : split)
+        word = ~word;
+      if (nbTaxa % 64 != 0)
+        split.back() &= (uint64_t(1) << (nbTaxa % 64)) - 1;
+    }
+    splits.push_back(make_pair(nodeId, split));
+  }
+  return splits;
+}
+
+/******************************************************************************/
+
+void BipartitionCounter::addTree(const Tree& tree)
+{
+  vector<pair<int, Split>> splits = getSplits(tree);
+
+  // With a rooted tree, the two branches at the root are a single one:
+  int rootId = tree.getRootId();
+  vector<int> rootSons = tree.getSonsId(rootId);
+  auto getLength = [&](int nodeId, double& length) {
+      if (!tree.hasDistanceToFather(nodeId))
+        return false;
+      length = tree.getDistanceToFather(nodeId);
+      if (rootSons.size() == 2 && tree.getFatherId(nodeId) == rootId)
+      {
+        int siblingId = (rootSons[0] == nodeId ? rootSons[1] : rootSons[0]);
+        if (!tree.hasDistanceToFather(siblingId))
+          return false;
+        length += tree.getDistanceToFather(siblingId);
+      }
+      return true;
+    };
+
+  // Both sons of the root then define the same bipartition, which must be
+  // counted once:
+  vector<const Split*> rootSplits;
+  double length;
+  for (const auto& split : splits)
+  {
+    if (tree.getFatherId(split.first) == rootId)
+    {
+      bool isDuplicate = false;
+      for (const Split* rootSplit : rootSplits)
+        isDuplicate = isDuplicate || *rootSplit == split.second;
+      if (isDuplicate)
+        continue;
+      rootSplits.push_back(&split.second);
+    }
+    size_t index = insert_(split.second.data());
+    counts_[index]++;
+    if (getLength(split.first, length))
+      lengths_[index].add(length);
+  }
+
+  for (int leafId : tree.getLeavesId())
+  {
+    // A leaf at the root of a tree rooted on a terminal branch shares it
+    // with its sibling, and it is counted once:
+    if (rootSons.size() == 2 && leafId == rootSons[1] && tree.isLeaf(rootSons[0]))
+      continue;
+    if (getLength(leafId, length))
+      leafLengths_[taxonIndex_.at(tree.getNodeName(leafId))].add(length);
+  }
+  nbTrees_++;
+}
+
+/******************************************************************************/
+
+void BipartitionCounter::merge(const BipartitionCounter& other)
+{
+  if (other.taxa_ != taxa_)
+    throw Exception("BipartitionCounter::merge: counters are not over the same taxa.");
+  for (size_t i = 0; i < other.counts_.size(); ++i)
+  {
+    size_t index = insert_(&other.splits_[i * nbWords_]);
+    counts_[index] += other.counts_[i];
+    lengths_[index].merge(other.lengths_[i]);
+  }
+  for (size_t t = 0; t < taxa_.size(); ++t)
+    leafLengths_[t].merge(other.leafLengths_[t]);
+  nbTrees_ += other.nbTrees_;
+}
+
+/******************************************************************************/
+
+void BipartitionCounter::computeBootstrapValues(Tree& tree, int format) const
+{
+  for (const auto& split : getSplits(tree))
+  {
+    double count = static_cast<double>(getCount(split.second));
+    double value = count;
+    if (format >= 0)
+      value = round(count * pow(10., 2 + format) / static_cast<double>(nbTrees_)) / pow(10., format);
+    tree.setBranchProperty(split.first, TreeTools::BOOTSTRAP, Number<double>(value));
+  }
+}
+
+/******************************************************************************/
+
+unique_ptr<TreeTemplate<Node>> BipartitionCounter::getConsensusTree(double threshold, bool withLengths) const
+{
+  if (nbTrees_ == 0)
+    throw Exception("BipartitionCounter::getConsensusTree: no tree was counted.");
+  auto getWords = [this](size_t index) { return &splits_[index * nbWords_]; };
+
+  // Candidate bipartitions, most frequent first, ties broken by value so
+  // that the result depends neither on the hash table nor on the order in
+  // which trees were counted:
+  vector<size_t> candidates;
+  for (size_t i = 0; i < counts_.size(); ++i)
+  {
+    if (counts_[i] == nbTrees_ || static_cast<double>(counts_[i]) > threshold * static_cast<double>(nbTrees_))
+      candidates.push_back(i);
+  }
+  sort(candidates.begin(), candidates.end(),
+      [&](size_t i, size_t j) {
+        if (counts_[i] != counts_[j])
+          return counts_[i] > counts_[j];
+        return lexicographical_compare(getWords(i), getWords(i) + nbWords_, getWords(j), getWords(j) + nbWords_);
+      });
+
+  // Bipartitions never contain the first taxon: two of them are compatible
+  // if they are disjoint or nested.
+  auto isIncluded = [this](const uint64_t* s1, const uint64_t* s2) {
+      for (size_t w = 0; w < nbWords_; ++w)
+      {
+        if (s1[w] & ~s2[w])
+          return false;
+      }
+      return true;
+    };
+  auto isDisjoint = [this](const uint64_t* s1, const uint64_t* s2) {
+      for (size_t w = 0; w < nbWords_; ++w)
+      {
+        if (s1[w] & s2[w])
+          return false;
+      }
+      return true;
+    };
+  size_t maxNbSplits = taxa_.size() > 3 ? taxa_.size() - 3 : 0;
+  vector<size_t> splits;
+  for (size_t i = 0; i < candidates.size() && splits.size() < maxNbSplits; ++i)
+  {
+    const uint64_t* candidate = getWords(candidates[i]);
+    bool isCompatible = true;
+    for (size_t j = 0; j < splits.size() && isCompatible; ++j)
+    {
+      const uint64_t* split = getWords(splits[j]);
+      isCompatible = isDisjoint(candidate, split) || isIncluded(candidate, split) || isIncluded(split, candidate);
+    }
+    if (isCompatible)
+      splits.push_back(candidates[i]);
+  }
+
+  // Each bipartition is a node, below the smallest one containing it:
+  vector<size_t> sizes(splits.size(), 0);
+  for (size_t i = 0; i < splits.size(); ++i)
+  {
+    for (size_t w = 0; w < nbWords_; ++w)
+      sizes[i] += bitset<64>(getWords(splits[i])[w]).count();
+  }
+  vector<size_t> order(splits.size());
+  for (size_t i = 0; i < order.size(); ++i)
+    order[i] = i;
+  stable_sort(order.begin(), order.end(), [&sizes](size_t i, size_t j) { return sizes[i] > sizes[j]; });
+
+  Node* root = new Node();
+  vector<Node*> nodes(order.size());
+  for (size_t k = 0; k < order.size(); ++k)
+  {
+    const uint64_t* split = getWords(splits[order[k]]);
+    nodes[k] = new Node();
+    if (withLengths && lengths_[splits[order[k]]].number > 0)
+      nodes[k]->setDistanceToFather(lengths_[splits[order[k]]].mean);
+    Node* father = root;
+    for (size_t l = k; l > 0 && father == root; --l)
+    {
+      if (isIncluded(split, getWords(splits[order[l - 1]])))
+        father = nodes[l - 1];
+    }
+    father->addSon(nodes[k]);
+  }
+  for (size_t t = 0; t < taxa_.size(); ++t)
+  {
+    Node* leaf = new Node(taxa_[t]);
+    if (withLengths && leafLengths_[t].number > 0)
+      leaf->setDistanceToFather(leafLengths_[t].mean);
+    Node* father = root;
+    for (size_t l = order.size(); l > 0 && father == root && t > 0; --l)
+    {
+      if (getWords(splits[order[l - 1]])[t / 64] & (uint64_t(1) << (t % 64)))
+        father = nodes[l - 1];
+    }
+    father->addSon(leaf);
+  }
+
+  auto tree = unique_ptr<TreeTemplate<Node>>(new TreeTemplate<Node>(root));
+  tree->resetNodesId();
+  return tree;
+}
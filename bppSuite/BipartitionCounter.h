@@ -0,0 +1,222 @@
+//
+// File: BipartitionCounter.h
+// Created by: Bio++ Development Team
+// Created on: Oct Sun 18 2026
+//
+
+/*
+Copyright or © or Copr. Bio++ Development Team
+
+This software is a computer program whose purpose is to estimate
+phylogenies and evolutionary parameters from a dataset according to
+the maximum likelihood principle.
+
+This software is governed by the CeCILL  license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+*/
+
+#ifndef BPPSUITE_BIPARTITIONCOUNTER_H
+#define BPPSUITE_BIPARTITIONCOUNTER_H
+
+// From the STL:
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+// From bpp-phyl:
+#include <Bpp/Phyl/Tree/Tree.h>
+#include <Bpp/Phyl/Tree/TreeTemplate.h>
+
+namespace bpp
+{
+/**
+ * @brief Count the bipartitions of trees, one tree at a time.
+ *
+ * Leaves are indexed once, from the list of taxa given at construction.
+ * Each internal branch of a tree is then a bitset over this index,
+ * computed bottom-up in a single pass over the tree, and normalized so
+ * that the first taxon is never in the set. Bitsets are counted in a hash
+ * table: trees can be discarded as soon as they are added, and the memory
+ * used only depends on the number of distinct bipartitions.
+ *
+ * Bitsets are stored back to back in a single array, and the hash table
+ * only holds their indices, with open addressing. Each bipartition also
+ * has the running mean and variance of the lengths of its branch, and
+ * each taxon those of its terminal branch. With rooted trees, the two
+ * branches at the root are one branch.
+ *
+ * All trees must have the same set of leaves.
+ */
+class BipartitionCounter
+{
+public:
+  typedef std::vector<uint64_t> Split;
+
+  struct SplitHash
+  {
+    size_t operator()(const Split& split) const;
+  };
+
+  /**
+   * @brief Running mean and variance of branch lengths (Welford).
+   */
+  struct LengthStatistics
+  {
+    size_t number;
+    double mean;
+    double sumOfSquares;
+
+    LengthStatistics() : number(0), mean(0), sumOfSquares(0) {}
+
+    void add(double length);
+
+    void merge(const LengthStatistics& statistics);
+
+    /**
+     * @return The unbiased variance, 0 with less than two lengths.
+     */
+    double getVariance() const { return number > 1 ? sumOfSquares / static_cast<double>(number - 1) : 0; }
+  };
+
+private:
+  std::vector<std::string> taxa_;
+  std::map<std::string, size_t> taxonIndex_;
+  size_t nbWords_;
+
+  /**
+   * @brief Bipartitions, nbWords_ words each, in order of first occurrence.
+   */
+  std::vector<uint64_t> splits_;
+  std::vector<size_t> counts_;
+  std::vector<LengthStatistics> lengths_;
+
+  /**
+   * @brief Hash table of bipartition indices, with linear probing. Its
+   * size is a power of two, at least twice the number of bipartitions.
+   */
+  std::vector<size_t> table_;
+
+  std::vector<LengthStatistics> leafLengths_;
+  size_t nbTrees_;
+
+public:
+  BipartitionCounter(const std::vector<std::string>& taxa);
+
+public:
+  const std::vector<std::string>& getTaxa() const { return taxa_; }
+
+  size_t getNumberOfTrees() const { return nbTrees_; }
+
+  size_t getNumberOfSplits() const { return counts_.size(); }
+
+  /**
+   * @return The number of trees containing a bipartition.
+   */
+  size_t getCount(const Split& split) const;
+
+  /**
+   * @return The lengths of the branch of a bipartition, over the trees
+   * containing it.
+   */
+  LengthStatistics getBranchLengths(const Split& split) const;
+
+  /**
+   * @return The lengths of the terminal branch of a taxon.
+   */
+  const LengthStatistics& getLeafBranchLengths(size_t taxon) const { return leafLengths_[taxon]; }
+
+  /**
+   * @brief Count the bipartitions of a tree.
+   *
+   * @throw Exception if the leaves of the tree are not the taxa of the
+   * counter.
+   */
+  void addTree(const Tree& tree);
+
+  /**
+   * @brief Add the counts of another counter over the same taxa.
+   */
+  void merge(const BipartitionCounter& other);
+
+  /**
+   * @return The bipartition of each internal branch of a tree, with the
+   * id of the node below the branch. Trivial bipartitions, separating a
+   * single leaf, are not included.
+   */
+  std::vector<std::pair<int, Split>> getSplits(const Tree& tree) const;
+
+  /**
+   * @brief Set the bootstrap value of each internal branch of a tree, as
+   * TreeTools::computeBootstrapValues does.
+   *
+   * @param tree   The tree to annotate, with the same leaves.
+   * @param format If positive or zero, values are percentages with this
+   * number of decimals, otherwise raw counts.
+   */
+  void computeBootstrapValues(Tree& tree, int format = 0) const;
+
+  /**
+   * @brief Build a consensus tree from the counted bipartitions, as
+   * TreeTools::thresholdConsensus does.
+   *
+   * Bipartitions found in more than a proportion `threshold` of the trees,
+   * or in all of them, are added from the most frequent one, provided they
+   * are compatible with those already added. 0 gives a fully resolved
+   * tree, 0.5 the majority rule consensus and 1 the strict consensus.
+   *
+   * @param threshold   The minimum proportion of trees.
+   * @param withLengths If true, branch lengths are the mean lengths of the
+   * branches in the trees containing them, when available.
+   * @return An unrooted tree.
+   * @throw Exception if no tree was counted.
+   */
+  std::unique_ptr<TreeTemplate<Node>> getConsensusTree(double threshold, bool withLengths = false) const;
+
+private:
+  /**
+   * @brief Marks empty slots of the hash table.
+   */
+  static const size_t NONE;
+
+  static size_t hash_(const uint64_t* words, size_t nbWords);
+
+  /**
+   * @return The slot of the table holding a bipartition, or the empty slot
+   * where it would be inserted.
+   */
+  size_t findSlot_(const uint64_t* words) const;
+
+  /**
+   * @return The index of a bipartition, which is added if needed.
+   */
+  size_t insert_(const uint64_t* words);
+};
+} // end of namespace bpp.
+
+#endif // BPPSUITE_BIPARTITIONCOUNTER_H
@@ -0,0 +1,209 @@
+//
+// File: BitParallelDistanceEstimation.cpp
+// Created by: Bio++ Development Team
+// Created on: Oct Sun 18 2026
+//
+
+/*
+Copyright or © or Copr. Bio++ Development Team
+
+This software is a computer program whose purpose is to estimate
+phylogenies and evolutionary parameters from a dataset according to
+the maximum likelihood principle.
+
+This software is governed by the CeCILL  license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+*/
+
+#include "BitParallelDistanceEstimation.h"
+#include "MinimizationTools.h"
+#include "ParallelTools.h"
+#include "PatternDistanceEstimation.h"
+
+// From the STL:
+#include <bitset>
+#include <cmath>
+#include <map>
+
+// From bpp-core:
+#include <Bpp/App/ApplicationTools.h>
+#include <Bpp/Numeric/NumConstants.h>
+
+// From bpp-phyl:
+#include <Bpp/Phyl/Model/Nucleotide/JC69.h>
+#include <Bpp/Phyl/Model/Nucleotide/K80.h>
+
+using namespace bpp;
+using namespace std;
+
+namespace
+{
+inline uint64_t popCount(uint64_t x)
+{
+  return static_cast<uint64_t>(bitset<64>(x).count());
+}
+}
+
+/******************************************************************************/
+
+BitParallelDistanceEstimation::BitParallelDistanceEstimation(const SiteContainerInterface& sites) :
+  names_(sites.getSequenceNames()),
+  nbWords_((sites.getNumberOfSites() + 63) / 64),
+  bits_(3 * names_.size() * nbWords_, 0),
+  hasPartiallyResolved_(false)
+{
+  auto alphabet = sites.getAlphabet();
+  size_t n = names_.size();
+  map<int, bool> partial;
+  for (size_t k = 0; k < sites.getNumberOfSites(); ++k)
+  {
+    const auto& site = sites.site(k);
+    size_t w = k / 64;
+    uint64_t bit = uint64_t(1) << (k % 64);
+    for (size_t i = 0; i < n; ++i)
+    {
+      int state = site[i];
+      if (state >= 0 && state < 4)
+      {
+        uint64_t* words = &bits_[3 * (i * nbWords_ + w)];
+        words[0] |= bit;
+        if (state & 1)
+          words[1] |= bit;
+        if (state & 2)
+          words[2] |= bit;
+      }
+      else
+      {
+        auto it = partial.find(state);
+        if (it == partial.end())
+          it = partial.insert(make_pair(state, !alphabet->isGap(state) && alphabet->getAlias(state).size() < 4)).first;
+        hasPartiallyResolved_ = hasPartiallyResolved_ || it->second;
+      }
+    }
+  }
+}
+
+/******************************************************************************/
+
+bool BitParallelDistanceEstimation::isSupported(const BranchModelInterface& model, const DiscreteDistributionInterface& rateDist)
+{
+  return (dynamic_cast<const JC69*>(&model) || dynamic_cast<const K80*>(&model))
+         && rateDist.getNumberOfCategories() == 1
+         && rateDist.getCategory(0) == 1.;
+}
+
+/******************************************************************************/
+
+void BitParallelDistanceEstimation::count(size_t i, size_t j, uint64_t& nbSites, uint64_t& nbTransitions, uint64_t& nbTransversions) const
+{
+  const uint64_t* bi = &bits_[3 * i * nbWords_];
+  const uint64_t* bj = &bits_[3 * j * nbWords_];
+  nbSites = 0;
+  nbTransitions = 0;
+  nbTransversions = 0;
+  for (size_t w = 0; w < 3 * nbWords_; w += 3)
+  {
+    uint64_t both = bi[w] & bj[w];
+    uint64_t transversions = (bi[w + 1] ^ bj[w + 1]) & both;
+    uint64_t transitions = (bi[w + 2] ^ bj[w + 2]) & both & ~transversions;
+    nbSites += popCount(both);
+    nbTransitions += popCount(transitions);
+    nbTransversions += popCount(transversions);
+  }
+}
+
+/******************************************************************************/
+
+unique_ptr<TriangularDistanceMatrix> BitParallelDistanceEstimation::computeMatrix(const BranchModelInterface& model, size_t nbThreads, size_t verbose, bool singlePrecision) const
+{
+  size_t n = names_.size();
+  auto matrix = make_unique<TriangularDistanceMatrix>(names_, singlePrecision);
+  if (n < 2)
+    return matrix;
+
+  // Rates of K80, normalized to one substitution per unit of time:
+  bool isJC = dynamic_cast<const JC69*>(&model) != nullptr;
+  double kappa = isJC ? 1. : model.getParameterValue("kappa");
+  double beta = 1. / (kappa + 2.);
+  double alphaBeta = (kappa + 1.) / (kappa + 2.);
+
+  auto estimate = [&](size_t i, size_t j) {
+      uint64_t nbSites, nbTransitions, nbTransversions;
+      count(i, j, nbSites, nbTransitions, nbTransversions);
+      if (nbSites == 0)
+        return PatternDistanceEstimation::MAX_DISTANCE;
+      double s = static_cast<double>(nbSites - nbTransitions - nbTransversions);
+      double p = static_cast<double>(nbTransitions);
+      double q = static_cast<double>(nbTransversions);
+      double d;
+      if (isJC)
+      {
+        double x = 1. - 4. / 3. * (p + q) / static_cast<double>(nbSites);
+        d = x > 0. ? -0.75 * log(x) : PatternDistanceEstimation::MAX_DISTANCE;
+      }
+      else
+      {
+        auto negLogLik = [&](double x) {
+            double t = exp(x);
+            double e1 = exp(-4. * beta * t);
+            double e2 = exp(-2. * alphaBeta * t);
+            double same = .25 + .25 * e1 + .5 * e2;
+            double transition = .25 + .25 * e1 - .5 * e2;
+            double transversion = .25 - .25 * e1;
+            return -(s * log(max(same, NumConstants::VERY_TINY()))
+                     + p * log(max(transition, NumConstants::VERY_TINY()))
+                     + q * log(max(transversion, NumConstants::VERY_TINY())));
+          };
+        d = exp(MinimizationTools::brent(negLogLik,
+                                         log(PatternDistanceEstimation::MIN_DISTANCE),
+                                         log(PatternDistanceEstimation::MAX_DISTANCE),
+                                         PatternDistanceEstimation::TOLERANCE));
+      }
+      return min(max(d, PatternDistanceEstimation::MIN_DISTANCE), PatternDistanceEstimation::MAX_DISTANCE);
+    };
+
+  size_t nbPairs = n * (n - 1) / 2;
+  size_t nbPairsDone = 0;
+  if (verbose)
+    ApplicationTools::displayTask("Compute pairwise distances", true);
+
+  ParallelTools::parallelFor(n - 1, nbThreads,
+    [&](size_t i, size_t)
+    {
+      for (size_t j = i + 1; j < n; ++j)
+        matrix->set(i, j, estimate(i, j));
+    },
+    [&](size_t i)
+    {
+      nbPairsDone += n - 1 - i;
+      if (verbose)
+        ApplicationTools::displayGauge(nbPairsDone, nbPairs, '=');
+    });
+
+  if (verbose)
+    ApplicationTools::displayTaskDone();
+  return matrix;
+}
@@ -0,0 +1,128 @@
+//
+// File: BitParallelDistanceEstimation.h
+// Created by: Bio++ Development Team
+// Created on: Oct Sun 18 2026
+//
+
+/*
+Copyright or © or Copr. Bio++ Development Team
+
+This software is a computer program whose purpose is to estimate
+phylogenies and evolutionary parameters from a dataset according to
+the maximum likelihood principle.
+
+This software is governed by the CeCILL  license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+*/
+
+#ifndef BPPSUITE_BITPARALLELDISTANCEESTIMATION_H
+#define BPPSUITE_BITPARALLELDISTANCEESTIMATION_H
+
+#include "TriangularDistanceMatrix.h"
+
+// From the STL:
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// From bpp-core:
+#include <Bpp/Numeric/Prob/DiscreteDistribution.h>
+
+// From bpp-seq:
+#include <Bpp/Seq/Container/SiteContainer.h>
+
+// From bpp-phyl:
+#include <Bpp/Phyl/Model/SubstitutionModel.h>
+
+namespace bpp
+{
+/**
+ * @brief Pairwise distances under JC69 and K80 from bit-packed sequences.
+ *
+ * Each nucleotide sequence is stored as three bit vectors, 64 sites per
+ * word: resolved states, pyrimidines, and G or T. For a pair of sequences,
+ * the numbers of compared sites, transitions and transversions are then
+ * obtained with a few logical operations and population counts per word.
+ *
+ * With a constant rate across sites and fixed model parameters, these
+ * counts are sufficient statistics: the JC69 distance has a closed form,
+ * and the K80 distance for a given kappa is a one-dimensional
+ * maximization of a closed-form likelihood. Both equal the maximum
+ * likelihood estimates of DistanceEstimation, as long as the sequences
+ * contain no partially resolved characters: gaps and fully unknown
+ * characters are ignored in both cases.
+ */
+class BitParallelDistanceEstimation
+{
+private:
+  std::vector<std::string> names_;
+  size_t nbWords_;
+
+  /**
+   * @brief The three bit vectors of each sequence, interleaved word by word.
+   */
+  std::vector<uint64_t> bits_;
+  bool hasPartiallyResolved_;
+
+public:
+  BitParallelDistanceEstimation(const SiteContainerInterface& sites);
+
+public:
+  /**
+   * @brief Tell if distances can be computed for a model and rate
+   * distribution.
+   */
+  static bool isSupported(const BranchModelInterface& model, const DiscreteDistributionInterface& rateDist);
+
+  /**
+   * @return True if some characters were neither resolved, gaps nor fully
+   * unknown. They are ignored, and distances then differ from the maximum
+   * likelihood ones.
+   */
+  bool hasPartiallyResolvedCharacters() const { return hasPartiallyResolved_; }
+
+  /**
+   * @brief Compute all pairwise distances, rows being shared between
+   * threads.
+   *
+   * @param model     A JC69 or K80 model.
+   * @param nbThreads Number of threads to use.
+   * @param verbose   If positive, progress is displayed in a gauge.
+   * @param singlePrecision If true, distances are stored in single
+   * precision.
+   */
+  std::unique_ptr<TriangularDistanceMatrix> computeMatrix(const BranchModelInterface& model, size_t nbThreads, size_t verbose = 1, bool singlePrecision = false) const;
+
+private:
+  /**
+   * @brief Count compared sites, transitions and transversions of a pair.
+   */
+  void count(size_t i, size_t j, uint64_t& nbSites, uint64_t& nbTransitions, uint64_t& nbTransversions) const;
+};
+} // end of namespace bpp.
+
+#endif // BPPSUITE_BITPARALLELDISTANCEESTIMATION_H
@@ -0,0 +1,155 @@
+//
+// File: BlockAlignmentWriter.cpp
+// Created by: Bio++ Development Team
+// Created on: Oct Sun 18 2026
+//
+
+/*
+Copyright or © or Copr. Bio++ Development Team
+
+This software is a computer program whose purpose is to simulate sequence
+data according to a phylogenetic tree and an evolutionary model.
+
+This software is governed by the CeCILL  license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+*/
+
+#include "BlockAlignmentWriter.h"
+
+// From the STL:
+#include <algorithm>
+#include <cstdio>
+
+// From bpp-core:
+#include <Bpp/Exceptions.h>
+#include <Bpp/Text/TextTools.h>
+
+using namespace bpp;
+using namespace std;
+
+BlockAlignmentWriter::BlockAlignmentWriter(const string& path, unsigned int charsByLine) :
+  path_(path),
+  tmpPath_(path + ".blocks.tmp"),
+  tmp_(tmpPath_.c_str(), ios::in | ios::out | ios::trunc | ios::binary),
+  charsByLine_(charsByLine),
+  names_(),
+  blocks_()
+{
+  if (!tmp_)
+    throw IOException("BlockAlignmentWriter: can't open temporary file " + tmpPath_);
+  if (charsByLine_ == 0)
+    throw Exception("BlockAlignmentWriter: number of characters per line must be positive.");
+}
+
+BlockAlignmentWriter::~BlockAlignmentWriter()
+{
+  if (tmp_.is_open())
+  {
+    tmp_.close();
+    remove(tmpPath_.c_str());
+  }
+}
+
+void BlockAlignmentWriter::appendBlock(const SiteContainerInterface& sites)
+{
+  vector<string> names = sites.getSequenceNames();
+  if (blocks_.size() == 0)
+    names_ = names;
+  else if (names != names_)
+    throw Exception("BlockAlignmentWriter::appendBlock: sequences differ from the previous blocks.");
+
+  size_t length = 0;
+  streamoff offset = tmp_.tellp();
+  for (size_t i = 0; i < names.size(); ++i)
+  {
+    string seq = sites.sequence(i).toString();
+    if (i == 0)
+      length = seq.size();
+    else if (seq.size() != length)
+      throw Exception("BlockAlignmentWriter::appendBlock: sequence " + names[i] + " has length " + TextTools::toString(seq.size()) + " instead of " + TextTools::toString(length) + ".");
+    tmp_.write(seq.data(), static_cast<streamsize>(length));
+  }
+  if (!tmp_)
+    throw IOException("BlockAlignmentWriter::appendBlock: error while writing to " + tmpPath_);
+  blocks_.push_back(make_pair(offset, length));
+}
+
+void BlockAlignmentWriter::close()
+{
+  tmp_.flush();
+  ofstream out(path_.c_str(), ios::out);
+  if (!out)
+    throw IOException("BlockAlignmentWriter::close: can't open file " + path_);
+
+  // Rows of consecutive sequences are contiguous in each block, so they
+  // are read by groups, with one seek per block and group, in a buffer
+  // bounded by the largest of BUFFER_SIZE and the size of one block.
+  size_t nbSequences = names_.size();
+  size_t length = 0;
+  size_t bufferSize = BUFFER_SIZE;
+  for (const auto& block : blocks_)
+  {
+    length += block.second;
+    bufferSize = max(bufferSize, nbSequences * block.second);
+  }
+  size_t groupSize = length > 0 ? max(bufferSize / length, static_cast<size_t>(1)) : nbSequences;
+
+  vector<char> buffer;
+  for (size_t first = 0; first < nbSequences; first += groupSize)
+  {
+    size_t n = min(groupSize, nbSequences - first);
+    buffer.resize(n * length);
+    size_t column = 0;
+    for (const auto& block : blocks_)
+    {
+      tmp_.seekg(block.first + static_cast<streamoff>(first * block.second));
+      for (size_t i = 0; i < n; ++i)
+        tmp_.read(buffer.data() + i * length + column, static_cast<streamsize>(block.second));
+      if (!tmp_)
+        throw IOException("BlockAlignmentWriter::close: error while reading " + tmpPath_);
+      column += block.second;
+    }
+
+    for (size_t i = 0; i < n; ++i)
+    {
+      out << ">" << names_[first + i] << '\n';
+      const char* row = buffer.data() + i * length;
+      for (size_t pos = 0; pos < length; pos += charsByLine_)
+      {
+        out.write(row + pos, static_cast<streamsize>(min(length - pos, static_cast<size_t>(charsByLine_))));
+        out << '\n';
+      }
+    }
+  }
+  out.close();
+  if (!out)
+    throw IOException("BlockAlignmentWriter::close: error while writing " + path_);
+
+  tmp_.close();
+  remove(tmpPath_.c_str());
+}
+
+const size_t BlockAlignmentWriter::BUFFER_SIZE = 1 << 26;
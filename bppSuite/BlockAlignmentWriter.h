@@ -0,0 +1,112 @@
+//
+// File: BlockAlignmentWriter.h
+// Created by: Bio++ Development Team
+// Created on: Oct Sun 18 2026
+//
+
+/*
+Copyright or © or Copr. Bio++ Development Team
+
+This software is a computer program whose purpose is to simulate sequence
+data according to a phylogenetic tree and an evolutionary model.
+
+This software is governed by the CeCILL  license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+*/
+
+#ifndef BPPSUITE_BLOCKALIGNMENTWRITER_H
+#define BPPSUITE_BLOCKALIGNMENTWRITER_H
+
+// From the STL:
+#include <string>
+#include <vector>
+#include <fstream>
+
+// From bpp-seq:
+#include <Bpp/Seq/Container/SiteContainer.h>
+
+namespace bpp
+{
+/**
+ * @brief Write an alignment to a Fasta file one block of sites at a time.
+ *
+ * Blocks are appended to a temporary file next to the output file, with
+ * the sequences of each block stored one after the other. When the writer
+ * is closed, the rows of all blocks are stitched together in the output
+ * file and the temporary file is removed. Only one block has to be kept in
+ * memory at a time, whatever the total length of the alignment.
+ */
+class BlockAlignmentWriter
+{
+private:
+  std::string path_;
+  std::string tmpPath_;
+  std::fstream tmp_;
+  unsigned int charsByLine_;
+  std::vector<std::string> names_;
+
+  /**
+   * @brief Offset in the temporary file and row length of each block.
+   */
+  std::vector<std::pair<std::streamoff, size_t>> blocks_;
+
+public:
+  /**
+   * @param path The output file.
+   * @param charsByLine Number of sequence characters per line.
+   */
+  BlockAlignmentWriter(const std::string& path, unsigned int charsByLine = 100);
+
+  BlockAlignmentWriter(const BlockAlignmentWriter&) = delete;
+  BlockAlignmentWriter& operator=(const BlockAlignmentWriter&) = delete;
+
+  virtual ~BlockAlignmentWriter();
+
+public:
+  /**
+   * @brief Append the sites of a block to the alignment.
+   *
+   * All blocks must have the same sequences, in the same order.
+   */
+  void appendBlock(const SiteContainerInterface& sites);
+
+  /**
+   * @brief Write the output file from all blocks appended so far.
+   */
+  void close();
+
+  size_t getNumberOfBlocks() const { return blocks_.size(); }
+
+public:
+  /**
+   * @brief Size in bytes of the buffer in which rows are gathered when the
+   * writer is closed, unless one block is larger.
+   */
+  static const size_t BUFFER_SIZE;
+};
+} // end of namespace bpp.
+
+#endif // BPPSUITE_BLOCKALIGNMENTWRITER_H
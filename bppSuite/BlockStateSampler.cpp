@@ -0,0 +1,92 @@
+//
+// File: BlockStateSampler.cpp
+// Created by: Bio++ Development Team
+// Created on: Oct Sun 18 2026
+//
+
+/*
+Copyright or © or Copr. Bio++ Development Team
+
+This software is a computer program whose purpose is to simulate sequence
+data according to a phylogenetic tree and an evolutionary model.
+
+This software is governed by the CeCILL  license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+*/
+
+#include "BlockStateSampler.h"
+
+// From bpp-core:
+#include <Bpp/Exceptions.h>
+#include <Bpp/Numeric/Random/RandomTools.h>
+#include <Bpp/Text/TextTools.h>
+
+using namespace bpp;
+using namespace std;
+
+BlockStateSampler::BlockStateSampler(size_t nbStates, size_t blockSize) :
+  nbStates_(nbStates),
+  blockSize_(blockSize),
+  probs_(nbStates * blockSize),
+  targets_(blockSize)
+{
+  if (nbStates_ == 0 || blockSize_ == 0)
+    throw Exception("BlockStateSampler: number of states and block size must be positive.");
+}
+
+void BlockStateSampler::sample(size_t nbSites, vector<size_t>& picks)
+{
+  if (nbSites > blockSize_)
+    throw Exception("BlockStateSampler::sample: " + TextTools::toString(nbSites) + " sites for a block of size " + TextTools::toString(blockSize_) + ".");
+
+  // Cumulated probabilities, one state row after the other:
+  for (size_t j = 1; j < nbStates_; ++j)
+  {
+    const double* prev = &probs_[(j - 1) * blockSize_];
+    double* cur = &probs_[j * blockSize_];
+    for (size_t i = 0; i < nbSites; ++i)
+      cur[i] += prev[i];
+  }
+
+  // Random targets, scaled to the total of each site:
+  const double* total = &probs_[(nbStates_ - 1) * blockSize_];
+  for (size_t i = 0; i < nbSites; ++i)
+  {
+    if (!(total[i] > 0))
+      throw Exception("BlockStateSampler::sample: all states have null probability at site " + TextTools::toString(i) + " of the block.");
+    targets_[i] = RandomTools::giveRandomNumberBetweenZeroAndEntry(1.) * total[i];
+  }
+
+  // The sampled state is the number of cumulated probabilities not above
+  // the target:
+  picks.assign(nbSites, 0);
+  for (size_t j = 0; j < nbStates_ - 1; ++j)
+  {
+    const double* cum = &probs_[j * blockSize_];
+    for (size_t i = 0; i < nbSites; ++i)
+      picks[i] += static_cast<size_t>(cum[i] <= targets_[i]);
+  }
+}
@@ -0,0 +1,98 @@
+//
+// File: BlockStateSampler.h
+// Created by: Bio++ Development Team
+// Created on: Oct Sun 18 2026
+//
+
+/*
+Copyright or © or Copr. Bio++ Development Team
+
+This software is a computer program whose purpose is to simulate sequence
+data according to a phylogenetic tree and an evolutionary model.
+
+This software is governed by the CeCILL  license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+*/
+
+#ifndef BPPSUITE_BLOCKSTATESAMPLER_H
+#define BPPSUITE_BLOCKSTATESAMPLER_H
+
+// From the STL:
+#include <vector>
+#include <cstddef>
+
+namespace bpp
+{
+/**
+ * @brief Sample one state per site for a block of sites at once.
+ *
+ * State probabilities of the block are stored state by state, so that
+ * the probabilities of a given state at consecutive sites are contiguous.
+ * Cumulated probabilities and the sampled states are then computed with
+ * loops over sites that the compiler can vectorize, and without branching
+ * on the sampled value.
+ */
+class BlockStateSampler
+{
+private:
+  size_t nbStates_;
+  size_t blockSize_;
+
+  /**
+   * @brief Probabilities, then cumulated probabilities, as a nbStates_ x blockSize_ matrix.
+   */
+  std::vector<double> probs_;
+  std::vector<double> targets_;
+
+public:
+  BlockStateSampler(size_t nbStates, size_t blockSize);
+
+public:
+  size_t getNumberOfStates() const { return nbStates_; }
+  size_t getBlockSize() const { return blockSize_; }
+
+  /**
+   * @brief Set the (possibly unnormalized) probability of a state at a site of the block.
+   */
+  void setProbability(size_t site, size_t state, double p)
+  {
+    probs_[state * blockSize_ + site] = p;
+  }
+
+  /**
+   * @brief Draw a state for each of the first sites of the block.
+   *
+   * Probabilities of the block are overwritten.
+   *
+   * @param nbSites Number of sites to sample, at most the block size.
+   * @param picks   Where to write the sampled states, resized to nbSites.
+   * @throw Exception if all probabilities of a site are null.
+   */
+  void sample(size_t nbSites, std::vector<size_t>& picks);
+};
+} // end of namespace bpp.
+
+#endif // BPPSUITE_BLOCKSTATESAMPLER_H
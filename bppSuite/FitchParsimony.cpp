@@ -0,0 +1,273 @@
+//
+// File: FitchParsimony.cpp
+// Created by: Bio++ Development Team
+// Created on: Oct Sun 18 2026
+//
+
+/*
+Copyright or © or Copr. Bio++ Development Team
+
+This software is a computer program whose purpose is to estimate
+phylogenies and evolutionary parameters from a dataset according to
+the maximum parsimony principle.
+
+This software is governed by the CeCILL  license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+*/
+
+#include "FitchParsimony.h"
+
+// From the STL:
+#include <bitset>
+
+// From bpp-core:
+#include <Bpp/Exceptions.h>
+
+using namespace bpp;
+using namespace std;
+
+/******************************************************************************/
+
+FitchParsimony::FitchParsimony(const SiteContainerInterface& sites, bool includeGaps) :
+  names_(sites.getSequenceNames()),
+  nameIndex_(),
+  nbStates_(sites.getAlphabet()->getSize() + (includeGaps ? 1 : 0)),
+  nbWords_(0),
+  nbPatterns_(0),
+  weights_(),
+  leafSets_()
+{
+  for (size_t i = 0; i < names_.size(); ++i)
+    nameIndex_[names_[i]] = i;
+
+  auto alphabet = sites.getAlphabet();
+  size_t nbResolved = alphabet->getSize();
+  size_t n = names_.size();
+
+  // States each character stands for:
+  map<int, vector<size_t>> states;
+  auto getStates = [&](int code) -> const vector<size_t>& {
+      auto it = states.find(code);
+      if (it != states.end())
+        return it->second;
+      vector<size_t>& codeStates = states[code];
+      if (code >= 0 && static_cast<size_t>(code) < nbResolved)
+        codeStates.push_back(static_cast<size_t>(code));
+      else if (alphabet->isGap(code) && includeGaps)
+        codeStates.push_back(nbResolved);
+      else if (alphabet->isGap(code))
+        for (size_t s = 0; s < nbResolved; ++s)
+          codeStates.push_back(s);
+      else
+        for (int s : alphabet->getAlias(code))
+          codeStates.push_back(static_cast<size_t>(s));
+      return codeStates;
+    };
+
+  // Count distinct patterns, leaving out those with a state common to all
+  // sequences:
+  map<vector<int>, unsigned int> patterns;
+  vector<int> column(n);
+  vector<size_t> stateCounts(nbStates_);
+  for (size_t k = 0; k < sites.getNumberOfSites(); ++k)
+  {
+    const auto& site = sites.site(k);
+    for (size_t i = 0; i < n; ++i)
+      column[i] = site[i];
+    auto it = patterns.find(column);
+    if (it != patterns.end())
+    {
+      it->second++;
+      continue;
+    }
+    std::fill(stateCounts.begin(), stateCounts.end(), 0);
+    for (size_t i = 0; i < n; ++i)
+      for (size_t s : getStates(column[i]))
+        stateCounts[s]++;
+    bool isFree = false;
+    for (size_t s = 0; s < nbStates_ && !isFree; ++s)
+      isFree = (stateCounts[s] == n);
+    if (!isFree)
+      patterns[column] = 1;
+  }
+  nbPatterns_ = patterns.size();
+
+  // Patterns with the same weight share words:
+  map<unsigned int, vector<const vector<int>*>> groups;
+  for (const auto& pattern : patterns)
+    groups[pattern.second].push_back(&pattern.first);
+  for (const auto& group : groups)
+    nbWords_ += (group.second.size() + 63) / 64;
+
+  leafSets_.assign(n, StateSets(nbWords_ * nbStates_, 0));
+  weights_.assign(nbWords_, 0);
+  size_t w = 0;
+  for (const auto& group : groups)
+  {
+    const auto& groupPatterns = group.second;
+    for (size_t first = 0; first < groupPatterns.size(); first += 64, ++w)
+    {
+      weights_[w] = group.first;
+      for (size_t b = 0; b < 64; ++b)
+      {
+        uint64_t bit = uint64_t(1) << b;
+        for (size_t i = 0; i < n; ++i)
+        {
+          uint64_t* sets = &leafSets_[i][w * nbStates_];
+          if (first + b < groupPatterns.size())
+          {
+            for (size_t s : getStates((*groupPatterns[first + b])[i]))
+              sets[s] |= bit;
+          }
+          else
+            // Padding: all leaves share the first state, at no cost.
+            sets[0] |= bit;
+        }
+      }
+    }
+  }
+}
+
+/******************************************************************************/
+
+size_t FitchParsimony::getLeafIndex(const string& name) const
+{
+  auto it = nameIndex_.find(name);
+  if (it == nameIndex_.end())
+    throw Exception("FitchParsimony: no sequence named '" + name + "'.");
+  return it->second;
+}
+
+/******************************************************************************/
+
+unsigned int FitchParsimony::combine(const uint64_t* sets1, const uint64_t* sets2, uint64_t* result) const
+{
+  unsigned int cost = 0;
+  for (size_t w = 0; w < nbWords_; ++w)
+  {
+    const uint64_t* a = sets1 + w * nbStates_;
+    const uint64_t* b = sets2 + w * nbStates_;
+    uint64_t* r = result + w * nbStates_;
+    uint64_t any = 0;
+    for (size_t s = 0; s < nbStates_; ++s)
+    {
+      r[s] = a[s] & b[s];
+      any |= r[s];
+    }
+    // Union where the intersection is empty:
+    uint64_t none = ~any;
+    for (size_t s = 0; s < nbStates_; ++s)
+      r[s] |= (a[s] | b[s]) & none;
+    cost += weights_[w] * static_cast<unsigned int>(bitset<64>(none).count());
+  }
+  return cost;
+}
+
+/******************************************************************************/
+
+unsigned int FitchParsimony::getCost(const uint64_t* sets1, const uint64_t* sets2) const
+{
+  unsigned int cost = 0;
+  for (size_t w = 0; w < nbWords_; ++w)
+  {
+    const uint64_t* a = sets1 + w * nbStates_;
+    const uint64_t* b = sets2 + w * nbStates_;
+    uint64_t any = 0;
+    for (size_t s = 0; s < nbStates_; ++s)
+      any |= a[s] & b[s];
+    cost += weights_[w] * static_cast<unsigned int>(bitset<64>(~any).count());
+  }
+  return cost;
+}
+
+/******************************************************************************/
+
+unsigned int FitchParsimony::getInsertionCost(const uint64_t* sets1, const uint64_t* sets2, const uint64_t* sets, unsigned int maxCost) const
+{
+  unsigned int cost = 0;
+  for (size_t w = 0; w < nbWords_ && cost < maxCost; ++w)
+  {
+    const uint64_t* a = sets1 + w * nbStates_;
+    const uint64_t* b = sets2 + w * nbStates_;
+    const uint64_t* c = sets + w * nbStates_;
+    uint64_t any = 0;
+    for (size_t s = 0; s < nbStates_; ++s)
+      any |= a[s] & b[s];
+    uint64_t none = ~any;
+    uint64_t anyC = 0;
+    for (size_t s = 0; s < nbStates_; ++s)
+      anyC |= ((a[s] & b[s]) | ((a[s] | b[s]) & none)) & c[s];
+    cost += weights_[w] * static_cast<unsigned int>(bitset<64>(~anyC).count());
+  }
+  return cost;
+}
+
+/******************************************************************************/
+
+unsigned int FitchParsimony::getScore(const Tree& tree) const
+{
+  // Nodes in pre-order, without recursion so that deep trees are fine:
+  int rootId = tree.getRootId();
+  vector<int> order(1, rootId);
+  for (size_t k = 0; k < order.size(); ++k)
+  {
+    vector<int> sons = tree.getSonsId(order[k]);
+    size_t maxSons = (order[k] == rootId ? 3 : 2);
+    if (sons.size() == 1 || sons.size() > maxSons)
+      throw Exception("FitchParsimony::getScore: the tree must be bifurcating.");
+    order.insert(order.end(), sons.begin(), sons.end());
+  }
+
+  // Sets of internal nodes, bottom-up:
+  size_t size = getSize();
+  map<int, StateSets> nodeSets;
+  unsigned int score = 0;
+  for (size_t k = order.size(); k > 0; --k)
+  {
+    int nodeId = order[k - 1];
+    vector<int> sons = tree.getSonsId(nodeId);
+    if (sons.empty())
+      continue;
+    auto getSets = [&](int sonId) -> const uint64_t* {
+        if (tree.getSonsId(sonId).empty())
+          return leafSets_[getLeafIndex(tree.getNodeName(sonId))].data();
+        return nodeSets[sonId].data();
+      };
+    StateSets& sets = nodeSets[nodeId];
+    sets.resize(size);
+    score += combine(getSets(sons[0]), getSets(sons[1]), sets.data());
+    if (sons.size() == 3)
+    {
+      StateSets sets2(size);
+      score += combine(sets.data(), getSets(sons[2]), sets2.data());
+      sets.swap(sets2);
+    }
+    // Sets of sons are no longer needed:
+    for (int sonId : sons)
+      nodeSets.erase(sonId);
+  }
+  return score;
+}
@@ -0,0 +1,162 @@
+//
+// File: FitchParsimony.h
+// Created by: Bio++ Development Team
+// Created on: Oct Sun 18 2026
+//
+
+/*
+Copyright or © or Copr. Bio++ Development Team
+
+This software is a computer program whose purpose is to estimate
+phylogenies and evolutionary parameters from a dataset according to
+the maximum parsimony principle.
+
+This software is governed by the CeCILL  license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+*/
+
+#ifndef BPPSUITE_FITCHPARSIMONY_H
+#define BPPSUITE_FITCHPARSIMONY_H
+
+// From the STL:
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <string>
+#include <vector>
+
+// From bpp-seq:
+#include <Bpp/Seq/Container/SiteContainer.h>
+
+// From bpp-phyl:
+#include <Bpp/Phyl/Tree/Tree.h>
+
+namespace bpp
+{
+/**
+ * @brief Fitch parsimony on state sets packed across sites.
+ *
+ * Distinct site patterns are counted once, and patterns which cost
+ * nothing on any tree, because all sequences share a possible state, are
+ * dropped. The remaining patterns are grouped by number of occurrences and
+ * laid out 64 per word, so that each word has a single weight. The state
+ * set of a node is stored as one bit plane per state and per word: the
+ * Fitch intersection and union of two nodes are then a few logical
+ * operations per word, and the cost of a word is the population count of
+ * the patterns with an empty intersection, times the weight of the word.
+ *
+ * As in DRTreeParsimonyScore, gaps are an additional state if
+ * includeGaps is true, and unknown characters otherwise. Scores are those
+ * of bifurcating trees; the root may have three sons.
+ *
+ * The engine is const once built: state set buffers belong to callers, so
+ * that several trees can be scored at the same time.
+ */
+class FitchParsimony
+{
+public:
+  typedef std::vector<uint64_t> StateSets;
+
+private:
+  std::vector<std::string> names_;
+  std::map<std::string, size_t> nameIndex_;
+  size_t nbStates_;
+  size_t nbWords_;
+  size_t nbPatterns_;
+
+  /**
+   * @brief Number of sites with each pattern of a word.
+   */
+  std::vector<unsigned int> weights_;
+
+  /**
+   * @brief State sets of the leaves, in the order of the names.
+   */
+  std::vector<StateSets> leafSets_;
+
+public:
+  FitchParsimony(const SiteContainerInterface& sites, bool includeGaps = false);
+
+public:
+  const std::vector<std::string>& getNames() const { return names_; }
+
+  /**
+   * @return The index of a sequence, as used by getLeafStateSets.
+   * @throw Exception if there is no such sequence.
+   */
+  size_t getLeafIndex(const std::string& name) const;
+
+  size_t getNumberOfStates() const { return nbStates_; }
+
+  /**
+   * @return The number of site patterns which may cost something.
+   */
+  size_t getNumberOfPatterns() const { return nbPatterns_; }
+
+  /**
+   * @return The number of words of a state set buffer.
+   */
+  size_t getSize() const { return nbWords_ * nbStates_; }
+
+  const StateSets& getLeafStateSets(size_t leaf) const { return leafSets_[leaf]; }
+
+  /**
+   * @brief The Fitch step: compute the state sets of a node from those of
+   * its two sons.
+   *
+   * @return The number of changes on the branches to the sons.
+   */
+  unsigned int combine(const uint64_t* sets1, const uint64_t* sets2, uint64_t* result) const;
+
+  /**
+   * @return The cost of the union of two nodes, that is the number of
+   * changes added by joining them, without computing the state sets.
+   */
+  unsigned int getCost(const uint64_t* sets1, const uint64_t* sets2) const;
+
+  /**
+   * @return The number of changes added by attaching a subtree with state
+   * sets `sets` on the branch between two nodes, given the state sets of
+   * each side of the branch.
+   *
+   * This is the cost of the union of `sets` with the Fitch sets of a root
+   * placed on the branch, computed one word at a time.
+   *
+   * @param maxCost The computation stops as soon as the cost reaches this
+   * value, which is then a lower bound of the cost.
+   */
+  unsigned int getInsertionCost(const uint64_t* sets1, const uint64_t* sets2, const uint64_t* sets, unsigned int maxCost = std::numeric_limits<unsigned int>::max()) const;
+
+  /**
+   * @return The parsimony score of a tree.
+   * @throw Exception if a leaf is not in the alignment or a node has more
+   * than two sons, the root excepted.
+   */
+  unsigned int getScore(const Tree& tree) const;
+};
+} // end of namespace bpp.
+
+#endif // BPPSUITE_FITCHPARSIMONY_H
@@ -0,0 +1,161 @@
+//
+// File: MinimizationTools.h
+// Created by: Bio++ Development Team
+// Created on: Oct Sun 18 2026
+//
+
+/*
+Copyright or © or Copr. Bio++ Development Team
+
+This software is a computer program whose purpose is to estimate
+phylogenies and evolutionary parameters from a dataset according to
+the maximum likelihood principle.
+
+This software is governed by the CeCILL  license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+*/
+
+#ifndef BPPSUITE_MINIMIZATIONTOOLS_H
+#define BPPSUITE_MINIMIZATIONTOOLS_H
+
+// From the STL:
+#include <algorithm>
+#include <cmath>
+
+namespace bpp
+{
+/**
+ * @brief Minimization of cheap functions of one variable.
+ *
+ * Unlike the optimizers of bpp-core, functions are plain callables and
+ * no ParameterList is involved, which matters when the function is a
+ * closed-form expression evaluated millions of times.
+ */
+class MinimizationTools
+{
+public:
+  static constexpr double GOLDEN = 0.3819660112501051;
+
+public:
+  /**
+   * @brief Brent's minimization of a function on an interval.
+   *
+   * @param f   The function to minimize.
+   * @param a   Lower bound of the interval.
+   * @param b   Upper bound of the interval.
+   * @param tol Relative tolerance on the position of the minimum.
+   * @return The position of the minimum.
+   */
+  template<class F>
+  static double brent(F f, double a, double b, double tol)
+  {
+    return brent(f, a, b, tol, a + GOLDEN * (b - a));
+  }
+
+  /**
+   * @brief Brent's minimization, starting from a given point, typically a
+   * previous estimate of the minimum.
+   */
+  template<class F>
+  static double brent(F f, double a, double b, double tol, double start)
+  {
+    const double golden = GOLDEN;
+    double x = std::min(std::max(start, a), b);
+    double w = x, v = x;
+    double fx = f(x), fw = fx, fv = fx;
+    double d = 0., e = 0.;
+    for (unsigned int iter = 0; iter < 200; ++iter)
+    {
+      double m = 0.5 * (a + b);
+      double tol1 = tol * std::fabs(x) + 1e-10;
+      double tol2 = 2. * tol1;
+      if (std::fabs(x - m) <= tol2 - 0.5 * (b - a))
+        break;
+
+      bool goldenStep = true;
+      if (std::fabs(e) > tol1)
+      {
+        // Parabolic interpolation:
+        double r = (x - w) * (fx - fv);
+        double q = (x - v) * (fx - fw);
+        double p = (x - v) * q - (x - w) * r;
+        q = 2. * (q - r);
+        if (q > 0.)
+          p = -p;
+        else
+          q = -q;
+        double etemp = e;
+        e = d;
+        if (std::fabs(p) < std::fabs(0.5 * q * etemp) && p > q * (a - x) && p < q * (b - x))
+        {
+          d = p / q;
+          double u = x + d;
+          if (u - a < tol2 || b - u < tol2)
+            d = (m > x) ? tol1 : -tol1;
+          goldenStep = false;
+        }
+      }
+      if (goldenStep)
+      {
+        e = (x < m) ? b - x : a - x;
+        d = golden * e;
+      }
+
+      double u = (std::fabs(d) >= tol1) ? x + d : x + (d > 0. ? tol1 : -tol1);
+      double fu = f(u);
+      if (fu <= fx)
+      {
+        if (u < x)
+          b = x;
+        else
+          a = x;
+        v = w; fv = fw;
+        w = x; fw = fx;
+        x = u; fx = fu;
+      }
+      else
+      {
+        if (u < x)
+          a = u;
+        else
+          b = u;
+        if (fu <= fw || w == x)
+        {
+          v = w; fv = fw;
+          w = u; fw = fu;
+        }
+        else if (fu <= fv || v == x || v == w)
+        {
+          v = u; fv = fu;
+        }
+      }
+    }
+    return x;
+  }
+};
+} // end of namespace bpp.
+
+#endif // BPPSUITE_MINIMIZATIONTOOLS_H
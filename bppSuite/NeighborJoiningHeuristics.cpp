@@ -0,0 +1,297 @@
+//
+// File: NeighborJoiningHeuristics.cpp
+// Created by: Bio++ Development Team
+// Created on: Oct Sun 18 2026
+//
+
+/*
+Copyright or © or Copr. Bio++ Development Team
+
+This software is a computer program whose purpose is to estimate
+phylogenies and evolutionary parameters from a dataset according to
+the maximum likelihood principle.
+
+This software is governed by the CeCILL  license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+*/
+
+#include "NeighborJoiningHeuristics.h"
+
+// From the STL:
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+// From bpp-core:
+#include <Bpp/App/ApplicationTools.h>
+#include <Bpp/Exceptions.h>
+#include <Bpp/Text/TextTools.h>
+
+using namespace bpp;
+using namespace std;
+
+/******************************************************************************/
+
+void IncrementalNeighborJoining::computeTree()
+{
+  size_t size = triangular_ ? triangular_->size() : matrix_.size();
+  size_t nbFinal = rootTree_ ? 2 : 3;
+  if (size < nbFinal)
+    throw Exception("IncrementalNeighborJoining::computeTree: at least " + TextTools::toString(nbFinal) + " sequences are needed.");
+
+  currentNodes_.clear();
+  for (size_t i = 0; i < size; ++i)
+    currentNodes_[i] = getLeafNode(static_cast<int>(i), triangular_ ? triangular_->getNames()[i] : matrix_.getName(i));
+  alive_.assign(size, true);
+  birth_.assign(size, 0);
+  rows_.assign(size, vector<float>());
+  sumDist_.assign(size, 0.);
+  for (size_t i = 1; i < size; ++i)
+  {
+    for (size_t j = 0; j < i; ++j)
+    {
+      double d = distance_(i, j);
+      sumDist_[i] += d;
+      sumDist_[j] += d;
+    }
+  }
+  initialize();
+
+  int idNextNode = static_cast<int>(size);
+  size_t step = 0;
+  while (currentNodes_.size() > nbFinal)
+  {
+    if (verbose_)
+      ApplicationTools::displayGauge(size - currentNodes_.size(), size - nbFinal - 1);
+    vector<size_t> bestPair = findBestPair();
+    size_t merged = bestPair[0];
+    size_t removed = bestPair[1];
+
+    double d = distance_(merged, removed);
+    double ratio = (sumDist_[merged] - sumDist_[removed]) / static_cast<double>(currentNodes_.size() - 2);
+    double length0 = .5 * (d + ratio);
+    double length1 = .5 * (d - ratio);
+    if (positiveLengths_)
+    {
+      length0 = max(length0, 0.);
+      length1 = max(length1, 0.);
+    }
+    Node* node0 = currentNodes_[merged];
+    Node* node1 = currentNodes_[removed];
+    node0->setDistanceToFather(length0);
+    node1->setDistanceToFather(length1);
+    Node* parent = getParentNode(idNextNode++, node0, node1);
+
+    // Distances from the new node, in a row of its own, and row sums
+    // corrected accordingly:
+    vector<float> row(size, 0.f);
+    sumDist_[merged] = 0.;
+    for (const auto& node : currentNodes_)
+    {
+      size_t k = node.first;
+      if (k == merged || k == removed)
+        continue;
+      double d0 = distance_(merged, k);
+      double d1 = distance_(removed, k);
+      double dk = .5 * (d0 - length0 + d1 - length1);
+      if (positiveLengths_)
+        dk = max(dk, 0.);
+      row[k] = static_cast<float>(dk);
+      dk = static_cast<double>(row[k]);
+      sumDist_[k] += dk - d0 - d1;
+      sumDist_[merged] += dk;
+    }
+    currentNodes_[merged] = parent;
+    currentNodes_.erase(removed);
+    alive_[removed] = false;
+    vector<float>().swap(rows_[removed]);
+    rows_[merged].swap(row);
+    birth_[merged] = ++step;
+    update(merged, removed);
+  }
+  finalStep(idNextNode);
+  vector<vector<float>>().swap(rows_);
+}
+
+void IncrementalNeighborJoining::finalStep(int idRoot)
+{
+  Node* root = new Node(idRoot);
+  vector<size_t> indices;
+  for (const auto& node : currentNodes_)
+  {
+    indices.push_back(node.first);
+    root->addSon(node.second);
+  }
+  vector<double> lengths(indices.size());
+  if (indices.size() == 2)
+  {
+    lengths[0] = lengths[1] = distance_(indices[0], indices[1]) / 2.;
+  }
+  else
+  {
+    double d01 = distance_(indices[0], indices[1]);
+    double d02 = distance_(indices[0], indices[2]);
+    double d12 = distance_(indices[1], indices[2]);
+    lengths[0] = .5 * (d01 + d02 - d12);
+    lengths[1] = .5 * (d01 + d12 - d02);
+    lengths[2] = .5 * (d02 + d12 - d01);
+  }
+  for (size_t k = 0; k < indices.size(); ++k)
+    currentNodes_[indices[k]]->setDistanceToFather(positiveLengths_ ? max(lengths[k], 0.) : lengths[k]);
+  tree_.reset(new TreeTemplate<Node>(root));
+}
+
+/******************************************************************************/
+
+void RapidNeighborJoining::sortRow(size_t i)
+{
+  auto& row = sortedRows_[i];
+  row.clear();
+  for (const auto& node : currentNodes_)
+  {
+    size_t j = node.first;
+    if (isValid(i, j))
+      row.push_back(make_pair(static_cast<float>(distance_(i, j)), static_cast<uint32_t>(j)));
+  }
+  sort(row.begin(), row.end());
+  row.shrink_to_fit();
+  rowStarts_[i] = 0;
+}
+
+void RapidNeighborJoining::initialize()
+{
+  size_t size = alive_.size();
+  sortedRows_.assign(size, vector<pair<float, uint32_t>>());
+  rowStarts_.assign(size, 0);
+  for (const auto& node : currentNodes_)
+    sortRow(node.first);
+}
+
+void RapidNeighborJoining::update(size_t merged, size_t removed)
+{
+  sortedRows_[removed].clear();
+  sortedRows_[removed].shrink_to_fit();
+  sortRow(merged);
+}
+
+vector<size_t> RapidNeighborJoining::findBestPair()
+{
+  double maxSum = -numeric_limits<double>::infinity();
+  for (const auto& node : currentNodes_)
+    maxSum = max(maxSum, sumDist_[node.first]);
+  double factor = static_cast<double>(currentNodes_.size() - 2);
+
+  vector<size_t> bestPair(2);
+  double bestCrit = numeric_limits<double>::infinity();
+  for (const auto& node : currentNodes_)
+  {
+    size_t i = node.first;
+    const auto& row = sortedRows_[i];
+    // Entries at the start of the row which are no longer valid will never
+    // be again:
+    size_t& start = rowStarts_[i];
+    while (start < row.size() && !isValid(i, row[start].second))
+      start++;
+    double offset = sumDist_[i] + maxSum;
+    for (size_t k = start; k < row.size(); ++k)
+    {
+      // Stored distances are single precision, hence the margin:
+      double d = static_cast<double>(row[k].first);
+      if (factor * (d - 1e-6 * fabs(d)) - offset >= bestCrit)
+        break;
+      size_t j = row[k].second;
+      if (!isValid(i, j))
+        continue;
+      double crit = getCriterion(i, j);
+      if (crit < bestCrit)
+      {
+        bestCrit = crit;
+        bestPair[0] = min(i, j);
+        bestPair[1] = max(i, j);
+      }
+    }
+  }
+  return bestPair;
+}
+
+/******************************************************************************/
+
+size_t FastNeighborJoining::findPartner(size_t i) const
+{
+  size_t partner = i;
+  double bestCrit = numeric_limits<double>::infinity();
+  for (const auto& node : currentNodes_)
+  {
+    size_t j = node.first;
+    if (j == i)
+      continue;
+    double crit = getCriterion(i, j);
+    if (crit < bestCrit)
+    {
+      bestCrit = crit;
+      partner = j;
+    }
+  }
+  return partner;
+}
+
+void FastNeighborJoining::initialize()
+{
+  partners_.assign(alive_.size(), 0);
+  for (const auto& node : currentNodes_)
+    partners_[node.first] = findPartner(node.first);
+}
+
+void FastNeighborJoining::update(size_t merged, size_t removed)
+{
+  // Visible pairs with one of the agglomerated nodes now point to the new
+  // node, which uses the index of the first one:
+  for (const auto& node : currentNodes_)
+    if (partners_[node.first] == removed)
+      partners_[node.first] = merged;
+  partners_[merged] = findPartner(merged);
+}
+
+vector<size_t> FastNeighborJoining::findBestPair()
+{
+  vector<size_t> bestPair(2);
+  double bestCrit = numeric_limits<double>::infinity();
+  for (const auto& node : currentNodes_)
+  {
+    size_t i = node.first;
+    size_t j = partners_[i];
+    if (j == i)
+      continue;
+    double crit = getCriterion(i, j);
+    if (crit < bestCrit)
+    {
+      bestCrit = crit;
+      bestPair[0] = min(i, j);
+      bestPair[1] = max(i, j);
+    }
+  }
+  return bestPair;
+}
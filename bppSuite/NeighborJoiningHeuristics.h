@@ -0,0 +1,251 @@
+//
+// File: NeighborJoiningHeuristics.h
+// Created by: Bio++ Development Team
+// Created on: Oct Sun 18 2026
+//
+
+/*
+Copyright or © or Copr. Bio++ Development Team
+
+This software is a computer program whose purpose is to estimate
+phylogenies and evolutionary parameters from a dataset according to
+the maximum likelihood principle.
+
+This software is governed by the CeCILL  license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+*/
+
+#ifndef BPPSUITE_NEIGHBORJOININGHEURISTICS_H
+#define BPPSUITE_NEIGHBORJOININGHEURISTICS_H
+
+#include "TriangularDistanceMatrix.h"
+
+// From the STL:
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+// From bpp-phyl:
+#include <Bpp/Phyl/Distance/NeighborJoining.h>
+
+namespace bpp
+{
+/**
+ * @brief Neighbor joining with row sums updated at each step, and an input
+ * matrix which is never modified.
+ *
+ * NeighborJoining recomputes the sum of each row of the distance matrix
+ * before every agglomeration, which alone costs O(n^2) per step. Here the
+ * sums are computed once, then corrected with the distances of the new
+ * node. Subclasses only have to choose the pair to agglomerate.
+ *
+ * The input matrix is only read: distances to the node created at each
+ * step are stored in a row of their own, released when the node is
+ * agglomerated in turn. The matrix can thus be a TriangularDistanceMatrix,
+ * possibly mapped from a file, and is then neither copied nor expanded to
+ * a square matrix of doubles.
+ */
+class IncrementalNeighborJoining :
+  public NeighborJoining
+{
+private:
+  std::shared_ptr<const TriangularDistanceMatrix> triangular_;
+
+  /**
+   * @brief Distances from each node created by an agglomeration to the
+   * nodes which existed when it was created.
+   */
+  std::vector<std::vector<float>> rows_;
+
+protected:
+  /**
+   * @brief Tell which indices of the matrix are still in use.
+   */
+  std::vector<bool> alive_;
+
+  /**
+   * @brief The step at which the node at each index was created, 0 for
+   * leaves.
+   */
+  std::vector<size_t> birth_;
+
+public:
+  IncrementalNeighborJoining(bool rooted = false, bool positiveLengths = false, bool verbose = true) :
+    NeighborJoining(rooted, positiveLengths, verbose),
+    triangular_(), rows_(), alive_(), birth_()
+  {}
+
+  virtual ~IncrementalNeighborJoining() {}
+
+public:
+  void setDistanceMatrix(const DistanceMatrix& matrix) override
+  {
+    triangular_.reset();
+    NeighborJoining::setDistanceMatrix(matrix);
+  }
+
+  /**
+   * @brief Build the tree from a triangular matrix, which is kept and
+   * read, not copied.
+   */
+  void setDistanceMatrix(std::shared_ptr<const TriangularDistanceMatrix> matrix)
+  {
+    triangular_ = matrix;
+  }
+
+  void computeTree() override;
+
+protected:
+  void finalStep(int idRoot) override;
+
+  /**
+   * @return The distance between the nodes at indices i and j.
+   */
+  double distance_(size_t i, size_t j) const
+  {
+    if (birth_[i] < birth_[j])
+      std::swap(i, j);
+    if (birth_[i] > 0)
+      return static_cast<double>(rows_[i][j]);
+    return triangular_ ? (*triangular_)(i, j) : matrix_(i, j);
+  }
+
+  /**
+   * @return The neighbor joining criterion of a pair, to be minimized.
+   */
+  double getCriterion(size_t i, size_t j) const
+  {
+    return static_cast<double>(currentNodes_.size() - 2) * distance_(i, j) - sumDist_[i] - sumDist_[j];
+  }
+
+  /**
+   * @brief Called before the first agglomeration, once row sums are known.
+   */
+  virtual void initialize() = 0;
+
+  /**
+   * @brief Called after each agglomeration, once row sums are updated.
+   *
+   * @param merged  The index of the new node, which replaces the first
+   *                node of the agglomerated pair.
+   * @param removed The index of the second node of the pair, which is no
+   *                longer used.
+   */
+  virtual void update(size_t merged, size_t removed) = 0;
+
+  /**
+   * @return The pair of indices to agglomerate, smaller index first.
+   */
+  virtual std::vector<size_t> findBestPair() = 0;
+};
+
+/**
+ * @brief Exact neighbor joining, with the search of the best pair bounded
+ * as in RapidNJ.
+ *
+ * Simonsen, Mailund and Pedersen (2008), Rapid neighbour-joining, WABI.
+ *
+ * Each row of the matrix is kept sorted by distance. While scanning a row,
+ * the criterion of the remaining pairs is bounded below using the
+ * largest row sum, and the scan stops as soon as the bound exceeds the
+ * best criterion found. Each pair is stored in the row of the most
+ * recently created of its two nodes only; pairs whose other node has
+ * been agglomerated since are skipped. The tree is the one of
+ * NeighborJoining, up to ties.
+ */
+class RapidNeighborJoining :
+  public IncrementalNeighborJoining
+{
+private:
+  std::vector<std::vector<std::pair<float, uint32_t>>> sortedRows_;
+  std::vector<size_t> rowStarts_;
+
+public:
+  RapidNeighborJoining(bool rooted = false, bool positiveLengths = false, bool verbose = true) :
+    IncrementalNeighborJoining(rooted, positiveLengths, verbose),
+    sortedRows_(), rowStarts_()
+  {}
+
+  RapidNeighborJoining* clone() const override { return new RapidNeighborJoining(*this); }
+
+  std::string getName() const override { return "RapidNJ"; }
+
+protected:
+  void initialize() override;
+  void update(size_t merged, size_t removed) override;
+  std::vector<size_t> findBestPair() override;
+
+private:
+  void sortRow(size_t i);
+
+  /**
+   * @brief Tell if a pair stored in the row of i is still valid.
+   */
+  bool isValid(size_t i, size_t j) const
+  {
+    return alive_[j] && (birth_[j] < birth_[i] || (birth_[j] == birth_[i] && j < i));
+  }
+};
+
+/**
+ * @brief Heuristic neighbor joining in O(n^2), as in FastNJ.
+ *
+ * Elias and Lagergren (2009), Fast neighbor joining, Theoretical Computer
+ * Science 410:1993-2000.
+ *
+ * Each node keeps its best partner, the "visible" pair. Only visible pairs
+ * are compared at each step, and only the partner of the new node is
+ * searched for. The tree may differ from the NeighborJoining one.
+ */
+class FastNeighborJoining :
+  public IncrementalNeighborJoining
+{
+private:
+  std::vector<size_t> partners_;
+
+public:
+  FastNeighborJoining(bool rooted = false, bool positiveLengths = false, bool verbose = true) :
+    IncrementalNeighborJoining(rooted, positiveLengths, verbose),
+    partners_()
+  {}
+
+  FastNeighborJoining* clone() const override { return new FastNeighborJoining(*this); }
+
+  std::string getName() const override { return "FastNJ"; }
+
+protected:
+  void initialize() override;
+  void update(size_t merged, size_t removed) override;
+  std::vector<size_t> findBestPair() override;
+
+private:
+  size_t findPartner(size_t i) const;
+};
+} // end of namespace bpp.
+
+#endif // BPPSUITE_NEIGHBORJOININGHEURISTICS_H
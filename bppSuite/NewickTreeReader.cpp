@@ -0,0 +1,375 @@
+//
+// File: NewickTreeReader.cpp
+// Created by: Bio++ Development Team
+// Created on: Oct Sun 18 2026
+//
+
+/*
+Copyright or © or Copr. Bio++ Development Team
+
+This software is a computer program whose purpose is to estimate
+phylogenies and evolutionary parameters from a dataset according to
+the maximum likelihood principle.
+
+This software is governed by the CeCILL  license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+*/
+
+#include "NewickTreeReader.h"
+
+// From the STL:
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// From bpp-core:
+#include <Bpp/Exceptions.h>
+#include <Bpp/Numeric/Number.h>
+#include <Bpp/Text/TextTools.h>
+
+// From bpp-phyl:
+#include <Bpp/Phyl/Tree/TreeTools.h>
+
+using namespace bpp;
+using namespace std;
+
+namespace
+{
+bool isBlank(const char* begin, const char* end)
+{
+  for (const char* c = begin; c < end; ++c)
+  {
+    if (!isspace(static_cast<unsigned char>(*c)))
+      return false;
+  }
+  return true;
+}
+
+/**
+ * @brief Convert a branch length or a bootstrap value.
+ *
+ * Faster than TextTools::toDouble, which matters as there are numbers for
+ * almost every node.
+ */
+double toDouble(const string& s)
+{
+  char* end = nullptr;
+  double x = strtod(s.c_str(), &end);
+  if (s.empty() || end != s.c_str() + s.size())
+    throw IOException("NewickTreeReader::parse. Invalid number '" + s + "' in tree description.");
+  return x;
+}
+
+/**
+ * @brief Split a Newick description into tokens, in place.
+ */
+class NewickTokenizer
+{
+private:
+  const char* current_;
+  const char* end_;
+
+public:
+  NewickTokenizer(const char* begin, const char* end) :
+    current_(begin),
+    end_(end)
+  {}
+
+public:
+  /**
+   * @brief Skip blanks and comments.
+   *
+   * @return The next character, or ';' at the end of the description.
+   */
+  char peek()
+  {
+    while (current_ < end_)
+    {
+      if (*current_ == '[')
+      {
+        const void* close = memchr(current_, ']', static_cast<size_t>(end_ - current_));
+        if (!close)
+          throw IOException("NewickTreeReader::parse. Unterminated comment.");
+        current_ = static_cast<const char*>(close) + 1;
+      }
+      else if (isspace(static_cast<unsigned char>(*current_)))
+        current_++;
+      else
+        return *current_;
+    }
+    return ';';
+  }
+
+  /**
+   * @brief Skip the character returned by peek().
+   */
+  void next()
+  {
+    if (current_ < end_)
+      current_++;
+  }
+
+  /**
+   * @brief Read a label, possibly empty or quoted.
+   */
+  void readLabel(string& label)
+  {
+    label.clear();
+    if (peek() == '\'')
+    {
+      current_++;
+      while (true)
+      {
+        if (current_ >= end_)
+          throw IOException("NewickTreeReader::parse. Unterminated quoted label.");
+        if (*current_ == '\'')
+        {
+          // Quotes are doubled in quoted labels:
+          if (current_ + 1 < end_ && current_[1] == '\'')
+          {
+            label += '\'';
+            current_ += 2;
+          }
+          else
+          {
+            current_++;
+            return;
+          }
+        }
+        else
+          label += *current_++;
+      }
+    }
+    const char* begin = current_;
+    while (current_ < end_ && !isDelimiter_(*current_))
+    {
+      current_++;
+    }
+    const char* last = current_;
+    while (last > begin && isspace(static_cast<unsigned char>(last[-1])))
+    {
+      last--;
+    }
+    label.assign(begin, last);
+  }
+
+  /**
+   * @brief Read the optional length of the branch above a node.
+   */
+  void readLength(Node& node, string& buffer)
+  {
+    if (peek() != ':')
+      return;
+    next();
+    readLabel(buffer);
+    node.setDistanceToFather(toDouble(buffer));
+  }
+
+private:
+  static bool isDelimiter_(char c)
+  {
+    return c == '(' || c == ')' || c == ',' || c == ':' || c == ';' || c == '[';
+  }
+};
+}
+
+/******************************************************************************/
+
+NewickTreeReader::NewickTreeReader(const string& path) :
+  path_(path),
+  input_(),
+  mapping_(nullptr),
+  mappingLength_(0),
+  position_(0),
+  nbTrees_(0)
+{
+#ifndef _WIN32
+  int fd = open(path.c_str(), O_RDONLY);
+  struct stat status;
+  if (fd >= 0 && fstat(fd, &status) == 0 && status.st_size > 0)
+  {
+    size_t length = static_cast<size_t>(status.st_size);
+    void* mapping = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping != MAP_FAILED)
+    {
+      madvise(mapping, length, MADV_SEQUENTIAL);
+      mapping_ = mapping;
+      mappingLength_ = length;
+      return;
+    }
+  }
+  else if (fd >= 0)
+    close(fd);
+#endif
+
+  // No mapping, read the file as a stream:
+  input_.open(path.c_str(), ios::in);
+  if (!input_)
+    throw IOException("NewickTreeReader: failed to open file " + path + ".");
+}
+
+NewickTreeReader::~NewickTreeReader()
+{
+#ifndef _WIN32
+  if (mapping_)
+    munmap(mapping_, mappingLength_);
+#endif
+}
+
+/******************************************************************************/
+
+bool NewickTreeReader::nextDescription(Description& description)
+{
+  if (mapping_)
+  {
+    if (position_ >= mappingLength_)
+      return false;
+    const char* begin = static_cast<const char*>(mapping_) + position_;
+    size_t length = mappingLength_ - position_;
+    const char* end = static_cast<const char*>(memchr(begin, ';', length));
+    if (!end)
+    {
+      position_ = mappingLength_;
+      // Nothing after the last ';' but blanks:
+      if (isBlank(begin, begin + length))
+        return false;
+      throw IOException("NewickTreeReader: missing ';' at the end of file " + path_ + ".");
+    }
+    position_ += static_cast<size_t>(end - begin) + 1;
+    description.begin = begin;
+    description.end = end + 1;
+  }
+  else
+  {
+    string& buffer = description.buffer;
+    if (!getline(input_, buffer, ';'))
+      return false;
+    if (input_.eof())
+    {
+      if (isBlank(buffer.data(), buffer.data() + buffer.size()))
+        return false;
+      throw IOException("NewickTreeReader: missing ';' at the end of file " + path_ + ".");
+    }
+    buffer += ';';
+    description.begin = buffer.data();
+    description.end = buffer.data() + buffer.size();
+  }
+  nbTrees_++;
+  return true;
+}
+
+/******************************************************************************/
+
+bool NewickTreeReader::nextDescription(string& description)
+{
+  Description next;
+  if (!nextDescription(next))
+    return false;
+  description = TextTools::removeSurroundingWhiteSpaces(string(next.begin, next.end - 1)) + ";";
+  return true;
+}
+
+/******************************************************************************/
+
+unique_ptr<TreeTemplate<Node>> NewickTreeReader::nextTree()
+{
+  Description description;
+  if (!nextDescription(description))
+    return nullptr;
+  return parse(description);
+}
+
+/******************************************************************************/
+
+unique_ptr<TreeTemplate<Node>> NewickTreeReader::parse(const char* begin, const char* end)
+{
+  NewickTokenizer tokenizer(begin, end);
+  if (tokenizer.peek() == ';')
+    throw IOException("NewickTreeReader::parse. Empty tree description.");
+  // Nodes are attached to the tree as soon as they are created, so that
+  // they are all deleted with it if the description is not valid:
+  Node* node = new Node();
+  unique_ptr<TreeTemplate<Node>> tree(new TreeTemplate<Node>(node));
+  // The nodes whose sons are being read:
+  vector<Node*> ancestors;
+  string label;
+  bool isNewNode = true;
+  while (true)
+  {
+    if (isNewNode)
+    {
+      if (tokenizer.peek() == '(')
+      {
+        tokenizer.next();
+        ancestors.push_back(node);
+        node = new Node();
+        ancestors.back()->addSon(node);
+        continue;
+      }
+      tokenizer.readLabel(label);
+      node->setName(label);
+      tokenizer.readLength(*node, label);
+      isNewNode = false;
+    }
+    if (ancestors.empty())
+      break;
+    char c = tokenizer.peek();
+    if (c == ',')
+    {
+      tokenizer.next();
+      node = new Node();
+      ancestors.back()->addSon(node);
+      isNewNode = true;
+    }
+    else if (c == ')')
+    {
+      tokenizer.next();
+      node = ancestors.back();
+      ancestors.pop_back();
+      tokenizer.readLabel(label);
+      if (!label.empty())
+        node->setBranchProperty(TreeTools::BOOTSTRAP, Number<double>(toDouble(label)));
+      tokenizer.readLength(*node, label);
+    }
+    else if (c == ';')
+      throw IOException("NewickTreeReader::parse. Unexpected end of tree description, missing ')'.");
+    else
+      throw IOException("NewickTreeReader::parse. Unexpected '" + string(1, c) + "' in tree description.");
+  }
+  if (tokenizer.peek() != ';')
+    throw IOException("NewickTreeReader::parse. Unexpected characters at the end of the tree description.");
+  tree->resetNodesId();
+  return tree;
+}
@@ -0,0 +1,157 @@
+//
+// File: NewickTreeReader.h
+// Created by: Bio++ Development Team
+// Created on: Oct Sun 18 2026
+//
+
+/*
+Copyright or © or Copr. Bio++ Development Team
+
+This software is a computer program whose purpose is to estimate
+phylogenies and evolutionary parameters from a dataset according to
+the maximum likelihood principle.
+
+This software is governed by the CeCILL  license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+*/
+
+#ifndef BPPSUITE_NEWICKTREEREADER_H
+#define BPPSUITE_NEWICKTREEREADER_H
+
+// From the STL:
+#include <fstream>
+#include <memory>
+#include <string>
+
+// From bpp-phyl:
+#include <Bpp/Phyl/Tree/TreeTemplate.h>
+
+namespace bpp
+{
+/**
+ * @brief Read the trees of a Newick file one at a time.
+ *
+ * Tree descriptions are read up to their ';' and only parsed on demand,
+ * so that trees which are skipped, for instance during a burn-in, cost
+ * almost nothing, and so that the memory used does not depend on the
+ * number of trees in the file. Descriptions can be parsed in other
+ * threads than the one reading them.
+ *
+ * Where possible, the file is memory-mapped and split at ';' directly in
+ * the mapping. Descriptions are then parsed in place: the parser reads
+ * the tokens of a description in a single pass and builds the nodes as it
+ * goes, without copying the description or any of its subtrees.
+ */
+class NewickTreeReader
+{
+public:
+  /**
+   * @brief A tree description, with its ';'.
+   *
+   * [begin, end) points into the mapping of the file, which remains valid
+   * as long as the reader, or into buffer when the file is read as a
+   * stream. Descriptions are not copyable for this reason.
+   */
+  class Description
+  {
+  public:
+    const char* begin;
+    const char* end;
+    std::string buffer;
+
+  public:
+    Description() : begin(nullptr), end(nullptr), buffer() {}
+    Description(const Description&) = delete;
+    Description& operator=(const Description&) = delete;
+  };
+
+private:
+  std::string path_;
+  std::ifstream input_;
+  void* mapping_;
+  size_t mappingLength_;
+  size_t position_;
+  size_t nbTrees_;
+
+public:
+  /**
+   * @throw IOException if the file cannot be opened.
+   */
+  NewickTreeReader(const std::string& path);
+
+  NewickTreeReader(const NewickTreeReader&) = delete;
+  NewickTreeReader& operator=(const NewickTreeReader&) = delete;
+
+  ~NewickTreeReader();
+
+public:
+  /**
+   * @brief Read the next tree description.
+   *
+   * @return false if there are no more trees in the file.
+   * @throw IOException if the last description is not terminated.
+   */
+  bool nextDescription(Description& description);
+
+  /**
+   * @brief Read the next tree description into a string, with its ';'.
+   */
+  bool nextDescription(std::string& description);
+
+  /**
+   * @return The number of descriptions read so far.
+   */
+  size_t getNumberOfTreesRead() const { return nbTrees_; }
+
+  /**
+   * @return The next tree, or nullptr if there are no more trees.
+   */
+  std::unique_ptr<TreeTemplate<Node>> nextTree();
+
+  /**
+   * @brief Parse a tree description, internal node labels being bootstrap
+   * values.
+   *
+   * Labels may be quoted, and comments in square brackets are ignored.
+   * The description ends at its first ';', or at end if it has none.
+   *
+   * @throw IOException if the description is not valid.
+   */
+  static std::unique_ptr<TreeTemplate<Node>> parse(const char* begin, const char* end);
+
+  static std::unique_ptr<TreeTemplate<Node>> parse(const Description& description)
+  {
+    return parse(description.begin, description.end);
+  }
+
+  static std::unique_ptr<TreeTemplate<Node>> parse(const std::string& description)
+  {
+    return parse(description.data(), description.data() + description.size());
+  }
+};
+} // end of namespace bpp.
+
+#endif // BPPSUITE_NEWICKTREEREADER_H
@@ -0,0 +1,183 @@
+//
+// File: OutgroupRerooter.cpp
+// Created by: Bio++ Development Team
+// Created on: Oct Sun 18 2026
+//
+
+/*
+Copyright or © or Copr. Bio++ Development Team
+
+This software is a computer program whose purpose is to estimate
+phylogenies and evolutionary parameters from a dataset according to
+the maximum likelihood principle.
+
+This software is governed by the CeCILL  license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+*/
+
+#include "OutgroupRerooter.h"
+
+// From bpp-phyl:
+#include <Bpp/Phyl/Tree/TreeTemplateTools.h>
+#include <Bpp/Phyl/Tree/TreeTools.h>
+
+using namespace bpp;
+using namespace std;
+
+/******************************************************************************/
+
+OutgroupRerooter::OutgroupRerooter(const vector<vector<string>>& levels, bool tryAgain) :
+  levels_(),
+  tryAgain_(tryAgain)
+{
+  for (const auto& level : levels)
+  {
+    levels_.push_back(unordered_set<string>(level.begin(), level.end()));
+  }
+}
+
+/******************************************************************************/
+
+void OutgroupRerooter::countLeaves_(
+  const TreeTemplate<Node>& tree,
+  size_t level,
+  unordered_map<const Node*, pair<size_t, size_t>>& counts) const
+{
+  // Pre-order, so that sons are counted before their father when going
+  // through the nodes backwards:
+  vector<const Node*> nodes;
+  nodes.reserve(tree.getNumberOfNodes());
+  nodes.push_back(tree.getRootNode());
+  for (size_t i = 0; i < nodes.size(); ++i)
+  {
+    for (size_t j = 0; j < nodes[i]->getNumberOfSons(); ++j)
+    {
+      nodes.push_back(nodes[i]->getSon(j));
+    }
+  }
+  counts.clear();
+  counts.reserve(nodes.size());
+  for (size_t i = nodes.size(); i > 0; --i)
+  {
+    const Node* node = nodes[i - 1];
+    pair<size_t, size_t>& count = counts[node];
+    if (node->isLeaf())
+    {
+      count.first = 1;
+      count.second = levels_[level].count(node->getName());
+    }
+    else
+    {
+      for (size_t j = 0; j < node->getNumberOfSons(); ++j)
+      {
+        const pair<size_t, size_t>& sonCount = counts[node->getSon(j)];
+        count.first += sonCount.first;
+        count.second += sonCount.second;
+      }
+    }
+  }
+}
+
+/******************************************************************************/
+
+bool OutgroupRerooter::reroot(unique_ptr<TreeTemplate<Node>>& tree) const
+{
+  // Leaves are not modified by rerooting:
+  vector<Node*> leaves = tree->getLeaves();
+  unordered_map<const Node*, pair<size_t, size_t>> counts;
+  for (size_t t = 0; t < levels_.size(); ++t)
+  {
+    Node* outgroupLeaf = nullptr;
+    Node* ingroupLeaf = nullptr;
+    size_t nbOutgroup = 0;
+    for (Node* leaf : leaves)
+    {
+      if (levels_[t].count(leaf->getName()) > 0)
+      {
+        if (!outgroupLeaf)
+          outgroupLeaf = leaf;
+        nbOutgroup++;
+      }
+      else if (!ingroupLeaf)
+        ingroupLeaf = leaf;
+    }
+    if (nbOutgroup == 0)
+      continue;
+
+    if (ingroupLeaf)
+    {
+      // Root on an ingroup leaf, so that the outgroup is not split by the
+      // root, then climb to the most recent common ancestor of the outgroup:
+      tree->newOutGroup(ingroupLeaf);
+      countLeaves_(*tree, t, counts);
+      Node* newRoot = outgroupLeaf;
+      while (newRoot->hasFather() && counts[newRoot].second < nbOutgroup)
+      {
+        newRoot = newRoot->getFather();
+      }
+
+      if (counts[newRoot].first == nbOutgroup)
+      {
+        tree->newOutGroup(newRoot);
+        return true;
+      }
+
+      // The outgroup may still be a set of sons of its ancestor:
+      bool monophylOk = true;
+      for (size_t f = 0; f < newRoot->getNumberOfSons() && monophylOk; ++f)
+      {
+        const pair<size_t, size_t>& count = counts[newRoot->getSon(f)];
+        if (count.second != 0 && count.second != count.first)
+          monophylOk = false;
+      }
+      if (monophylOk)
+      {
+        if (counts[newRoot].first != leaves.size())
+        {
+          unique_ptr<TreeTemplate<Node>> low(new TreeTemplate<Node>(TreeTemplateTools::cloneSubtree<Node>(*newRoot)));
+          tree->newOutGroup(newRoot);
+          Node* root = tree->getRootNode();
+          Node* sonUpper = root->getSon(0) == newRoot ? root->getSon(1) : root->getSon(0);
+          root->removeSon(sonUpper);
+          int ident = TreeTools::getMaxId(*low, low->getRootId());
+          vector<Node*> nodesTemp = TreeTemplateTools::getNodes(*sonUpper);
+          for (size_t f = 0; f < nodesTemp.size(); ++f)
+          {
+            nodesTemp[f]->setId(ident + static_cast<int>(f + 1));
+          }
+          low->getRootNode()->addSon(sonUpper);
+          tree = move(low);
+        }
+        return true;
+      }
+    }
+    if (!tryAgain_)
+      return false;
+  }
+  return false;
+}
+
+/******************************************************************************/
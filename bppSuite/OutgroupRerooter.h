@@ -0,0 +1,105 @@
+//
+// File: OutgroupRerooter.h
+// Created by: Bio++ Development Team
+// Created on: Oct Sun 18 2026
+//
+
+/*
+Copyright or © or Copr. Bio++ Development Team
+
+This software is a computer program whose purpose is to estimate
+phylogenies and evolutionary parameters from a dataset according to
+the maximum likelihood principle.
+
+This software is governed by the CeCILL  license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+*/
+
+#ifndef BPPSUITE_OUTGROUPREROOTER_H
+#define BPPSUITE_OUTGROUPREROOTER_H
+
+// From the STL:
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// From bpp-phyl:
+#include <Bpp/Phyl/Tree/TreeTemplate.h>
+
+namespace bpp
+{
+/**
+ * @brief Root trees on the first available level of a list of outgroups.
+ *
+ * The outgroup levels are indexed once for the whole run, and each tree is
+ * annotated in a single post-order pass with, for every node, its number
+ * of leaves and its number of outgroup leaves. Finding the most recent
+ * common ancestor of the outgroup and checking its monophyly then cost a
+ * comparison per node, instead of a scan of leaf names.
+ *
+ * The rerooter is not modified by reroot(), so that several trees can be
+ * rooted concurrently.
+ */
+class OutgroupRerooter
+{
+private:
+  std::vector<std::unordered_set<std::string>> levels_;
+  bool tryAgain_;
+
+public:
+  /**
+   * @param levels   The outgroup levels, in order of preference.
+   * @param tryAgain Whether to try the next level when the outgroup of a
+   * level is present in the tree but is not monophyletic.
+   */
+  OutgroupRerooter(const std::vector<std::vector<std::string>>& levels, bool tryAgain);
+
+public:
+  /**
+   * @brief Root a tree on the first outgroup level present in it.
+   *
+   * When the outgroup is a set of sons of a multifurcating node, this node
+   * becomes the root and the tree is replaced.
+   *
+   * @return true if the tree could be rooted.
+   */
+  bool reroot(std::unique_ptr<TreeTemplate<Node>>& tree) const;
+
+private:
+  /**
+   * @brief Count the leaves, and the leaves of the given level, below
+   * each node.
+   */
+  void countLeaves_(
+    const TreeTemplate<Node>& tree,
+    size_t level,
+    std::unordered_map<const Node*, std::pair<size_t, size_t>>& counts) const;
+};
+} // end of namespace bpp.
+
+#endif // BPPSUITE_OUTGROUPREROOTER_H
@@ -0,0 +1,323 @@
+//
+// File: PackedAlignment.cpp
+// Created by: Bio++ Development Team
+// Created on: Oct Sun 18 2026
+//
+
+/*
+Copyright or © or Copr. Bio++ Development Team
+
+This software is a computer program whose purpose is to read and write
+sequence alignments in a compact binary format.
+
+This software is governed by the CeCILL  license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+*/
+
+#include "PackedAlignment.h"
+
+// From the STL:
+#include <fstream>
+#include <vector>
+#include <cstdint>
+
+// From bpp-core:
+#include <Bpp/Exceptions.h>
+#include <Bpp/Text/TextTools.h>
+#include <Bpp/Text/KeyvalTools.h>
+#include <Bpp/App/ApplicationTools.h>
+#include <Bpp/App/NumCalcApplicationTools.h>
+#include <Bpp/Numeric/Random/RandomTools.h>
+
+// From bpp-seq:
+#include <Bpp/Seq/Sequence.h>
+#include <Bpp/Seq/App/SequenceApplicationTools.h>
+#include <Bpp/Seq/Container/SiteContainerTools.h>
+
+using namespace bpp;
+using namespace std;
+
+const string PackedAlignment::FORMAT_NAME = "Packed";
+
+namespace
+{
+const char MAGIC[] = "BPPPACK";
+const char VERSION = 1;
+
+void writeUInt(ostream& out, uint64_t x, size_t nbBytes)
+{
+  for (size_t i = 0; i < nbBytes; ++i)
+    out.put(static_cast<char>((x >> (8 * i)) & 0xFF));
+}
+
+uint64_t readUInt(istream& in, size_t nbBytes)
+{
+  uint64_t x = 0;
+  for (size_t i = 0; i < nbBytes; ++i)
+  {
+    int c = in.get();
+    if (c == EOF)
+      throw IOException("PackedAlignment: unexpected end of file.");
+    x |= static_cast<uint64_t>(c & 0xFF) << (8 * i);
+  }
+  return x;
+}
+
+void writeString(ostream& out, const string& s)
+{
+  writeUInt(out, s.size(), 4);
+  out.write(s.data(), static_cast<streamsize>(s.size()));
+}
+
+string readString(istream& in)
+{
+  string s(static_cast<size_t>(readUInt(in, 4)), ' ');
+  in.read(&s[0], static_cast<streamsize>(s.size()));
+  if (!in)
+    throw IOException("PackedAlignment: unexpected end of file.");
+  return s;
+}
+}
+
+/******************************************************************************/
+
+unsigned int PackedAlignment::getNumberOfBitsPerState(const Alphabet& alphabet)
+{
+  unsigned int bits = 1;
+  while ((static_cast<size_t>(1) << bits) < alphabet.getSize())
+    bits++;
+  return bits;
+}
+
+/******************************************************************************/
+
+void PackedAlignment::writeAlignment(ostream& output, const SiteContainerInterface& sc) const
+{
+  if (!output)
+    throw IOException("PackedAlignment::writeAlignment: can't write to ostream output");
+
+  auto alphabet = sc.getAlphabet();
+  unsigned int bits = getNumberOfBitsPerState(*alphabet);
+  int size = static_cast<int>(alphabet->getSize());
+  size_t nbSeq = sc.getNumberOfSequences();
+  size_t nbPos = nbSeq > 0 ? sc.sequence(0).size() : 0;
+
+  output.write(MAGIC, 7);
+  output.put(VERSION);
+  writeString(output, alphabet->getAlphabetType());
+  output.put(static_cast<char>(bits));
+  writeUInt(output, nbSeq, 8);
+  writeUInt(output, nbPos, 8);
+
+  vector<char> packed((nbPos * bits + 7) / 8);
+  vector<char> mask((nbPos + 7) / 8);
+  vector<int> unresolved;
+  for (size_t i = 0; i < nbSeq; ++i)
+  {
+    const auto& seq = sc.sequence(i);
+    writeString(output, seq.getName());
+
+    std::fill(packed.begin(), packed.end(), 0);
+    std::fill(mask.begin(), mask.end(), 0);
+    unresolved.clear();
+
+    uint64_t buffer = 0;
+    unsigned int nbBuffered = 0;
+    size_t k = 0;
+    for (size_t j = 0; j < nbPos; ++j)
+    {
+      int state = seq[j];
+      if (state < 0 || state >= size)
+      {
+        mask[j / 8] = static_cast<char>(mask[j / 8] | (1 << (j % 8)));
+        unresolved.push_back(state);
+        state = 0;
+      }
+      buffer |= static_cast<uint64_t>(state) << nbBuffered;
+      nbBuffered += bits;
+      while (nbBuffered >= 8)
+      {
+        packed[k++] = static_cast<char>(buffer & 0xFF);
+        buffer >>= 8;
+        nbBuffered -= 8;
+      }
+    }
+    if (nbBuffered > 0)
+      packed[k] = static_cast<char>(buffer & 0xFF);
+
+    output.write(packed.data(), static_cast<streamsize>(packed.size()));
+    output.write(mask.data(), static_cast<streamsize>(mask.size()));
+    for (auto state : unresolved)
+      writeUInt(output, static_cast<uint64_t>(static_cast<uint16_t>(static_cast<int16_t>(state))), 2);
+  }
+  if (!output)
+    throw IOException("PackedAlignment::writeAlignment: error while writing.");
+}
+
+void PackedAlignment::writeAlignment(const string& path, const SiteContainerInterface& sc, bool overwrite) const
+{
+  ofstream output(path.c_str(), overwrite ? (ios::out | ios::binary) : (ios::out | ios::app | ios::binary));
+  writeAlignment(output, sc);
+  output.close();
+}
+
+/******************************************************************************/
+
+unique_ptr<VectorSiteContainer> PackedAlignment::readAlignment(istream& input, shared_ptr<const Alphabet> alphabet) const
+{
+  if (!input)
+    throw IOException("PackedAlignment::readAlignment: can't read from istream input");
+
+  char magic[7];
+  input.read(magic, 7);
+  if (!input || string(magic, 7) != MAGIC)
+    throw IOException("PackedAlignment::readAlignment: not a packed alignment.");
+  if (input.get() != VERSION)
+    throw IOException("PackedAlignment::readAlignment: unsupported format version.");
+
+  string alphabetType = readString(input);
+  if (alphabetType != alphabet->getAlphabetType())
+    throw Exception("PackedAlignment::readAlignment: alignment written with alphabet '" + alphabetType + "', not '" + alphabet->getAlphabetType() + "'.");
+  unsigned int bits = static_cast<unsigned int>(readUInt(input, 1));
+  if (bits != getNumberOfBitsPerState(*alphabet))
+    throw IOException("PackedAlignment::readAlignment: wrong number of bits per state: " + TextTools::toString(bits) + ".");
+  size_t nbSeq = static_cast<size_t>(readUInt(input, 8));
+  size_t nbPos = static_cast<size_t>(readUInt(input, 8));
+
+  auto sites = make_unique<VectorSiteContainer>(alphabet);
+
+  vector<char> packed((nbPos * bits + 7) / 8);
+  vector<char> mask((nbPos + 7) / 8);
+  uint64_t stateMask = (static_cast<uint64_t>(1) << bits) - 1;
+  for (size_t i = 0; i < nbSeq; ++i)
+  {
+    string name = readString(input);
+    input.read(packed.data(), static_cast<streamsize>(packed.size()));
+    input.read(mask.data(), static_cast<streamsize>(mask.size()));
+    if (!input)
+      throw IOException("PackedAlignment::readAlignment: unexpected end of file in sequence " + name + ".");
+
+    vector<int> content(nbPos);
+    uint64_t buffer = 0;
+    unsigned int nbBuffered = 0;
+    size_t k = 0;
+    for (size_t j = 0; j < nbPos; ++j)
+    {
+      while (nbBuffered < bits)
+      {
+        buffer |= static_cast<uint64_t>(static_cast<unsigned char>(packed[k++])) << nbBuffered;
+        nbBuffered += 8;
+      }
+      content[j] = static_cast<int>(buffer & stateMask);
+      buffer >>= bits;
+      nbBuffered -= bits;
+    }
+    for (size_t j = 0; j < nbPos; ++j)
+    {
+      if (mask[j / 8] & (1 << (j % 8)))
+        content[j] = static_cast<int16_t>(static_cast<uint16_t>(readUInt(input, 2)));
+    }
+
+    auto seq = make_unique<Sequence>(name, content, alphabet);
+    sites->addSequence(name, seq);
+  }
+  return sites;
+}
+
+unique_ptr<VectorSiteContainer> PackedAlignment::readAlignment(const string& path, shared_ptr<const Alphabet> alphabet) const
+{
+  ifstream input(path.c_str(), ios::in | ios::binary);
+  if (!input)
+    throw IOException("PackedAlignment::readAlignment: can't open file " + path);
+  auto sites = readAlignment(input, alphabet);
+  input.close();
+  return sites;
+}
+
+/******************************************************************************/
+
+unique_ptr<VectorSiteContainer> PackedAlignment::getSiteContainer(
+  shared_ptr<const Alphabet> alphabet,
+  const map<string, string>& params)
+{
+  string format = ApplicationTools::getStringParameter("input.sequence.format", params, "Fasta", "", true, 1);
+  string formatName;
+  map<string, string> formatArgs;
+  KeyvalTools::parseProcedure(format, formatName, formatArgs);
+  if (formatName != FORMAT_NAME)
+    return SequenceApplicationTools::getSiteContainer(alphabet, params);
+
+  string path = ApplicationTools::getAFilePath("input.sequence.file", params, true, true);
+  ApplicationTools::displayResult("Sequence file", path);
+  ApplicationTools::displayResult("Sequence format", FORMAT_NAME);
+  auto sites = PackedAlignment().readAlignment(path, alphabet);
+  ApplicationTools::displayResult("Number of sequences", TextTools::toString(sites->getNumberOfSequences()));
+
+  // Sequences and sites are selected as for the other formats:
+  SequenceApplicationTools::restrictSelectedSequencesByName(*sites, params);
+
+  string siteSet = ApplicationTools::getStringParameter("input.site.selection", params, "none", "", true, 2);
+  if (siteSet != "none")
+  {
+    vector<size_t> vSite;
+    try
+    {
+      vector<int> vSite1 = NumCalcApplicationTools::seqFromString(siteSet, ",", ":");
+      for (auto x : vSite1)
+      {
+        if (x < 0)
+          x += static_cast<int>(sites->getNumberOfSites());
+        if (x < 0)
+          throw Exception("PackedAlignment::getSiteContainer: incorrect negative index for site selection: " + TextTools::toString(x));
+        vSite.push_back(static_cast<size_t>(x));
+      }
+    }
+    catch (Exception& e)
+    {
+      string seln;
+      map<string, string> selArgs;
+      KeyvalTools::parseProcedure(siteSet, seln, selArgs);
+      if (seln != "Sample")
+        throw Exception("PackedAlignment::getSiteContainer: unknown site selection description: " + siteSet);
+      size_t n = ApplicationTools::getParameter<size_t>("n", selArgs, sites->getNumberOfSites(), "", true, 2);
+      bool replace = ApplicationTools::getBooleanParameter("replace", selArgs, false, "", true, 2);
+      vector<size_t> vPos(sites->getNumberOfSites());
+      for (size_t p = 0; p < vPos.size(); ++p)
+        vPos[p] = p;
+      vSite.resize(n);
+      RandomTools::getSample(vPos, vSite, replace);
+    }
+    for (auto x : vSite)
+    {
+      if (x >= sites->getNumberOfSites())
+        throw Exception("PackedAlignment::getSiteContainer: site selection out of range: " + TextTools::toString(x));
+    }
+    ApplicationTools::displayResult("Selected sites", siteSet);
+    sites = SiteContainerTools::getSelectedSites(*sites, vSite);
+    sites->reindexSites();
+  }
+  return sites;
+}
@@ -0,0 +1,121 @@
+//
+// File: PackedAlignment.h
+// Created by: Bio++ Development Team
+// Created on: Oct Sun 18 2026
+//
+
+/*
+Copyright or © or Copr. Bio++ Development Team
+
+This software is a computer program whose purpose is to read and write
+sequence alignments in a compact binary format.
+
+This software is governed by the CeCILL  license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+*/
+
+#ifndef BPPSUITE_PACKEDALIGNMENT_H
+#define BPPSUITE_PACKEDALIGNMENT_H
+
+// From the STL:
+#include <string>
+#include <map>
+#include <memory>
+#include <iostream>
+
+// From bpp-seq:
+#include <Bpp/Seq/Alphabet/Alphabet.h>
+#include <Bpp/Seq/Container/SiteContainer.h>
+#include <Bpp/Seq/Container/VectorSiteContainer.h>
+
+namespace bpp
+{
+/**
+ * @brief Compact binary alignment format.
+ *
+ * Each resolved state is stored on the smallest number of bits able to
+ * hold all states of the alphabet: 2 bits for nucleotides, 5 for amino
+ * acids, 6 for codons. Gaps, unknown and unresolved characters are flagged
+ * in a separate bit mask, and their codes are stored after it, so that
+ * any alignment is read back exactly as it was written.
+ *
+ * Layout (integers are little-endian):
+ * - "BPPPACK" followed by the format version byte (1);
+ * - alphabet type, as a uint32 length followed by the characters;
+ * - uint8 number of bits per state;
+ * - uint64 number of sequences and uint64 number of positions;
+ * - for each sequence:
+ *   - name, as a uint32 length followed by the characters;
+ *   - packed states, on ceil(positions * bits / 8) bytes;
+ *   - mask of gap and unresolved positions, on ceil(positions / 8) bytes;
+ *   - int16 character code of each position set in the mask.
+ *
+ * Reading is mostly bit unpacking, with no character parsing.
+ */
+class PackedAlignment
+{
+public:
+  static const std::string FORMAT_NAME;
+
+public:
+  PackedAlignment() {}
+  virtual ~PackedAlignment() {}
+
+public:
+  const std::string getFormatName() const { return FORMAT_NAME; }
+
+  void writeAlignment(std::ostream& output, const SiteContainerInterface& sc) const;
+
+  void writeAlignment(const std::string& path, const SiteContainerInterface& sc, bool overwrite = true) const;
+
+  /**
+   * @throw Exception if the file was written with another alphabet.
+   */
+  std::unique_ptr<VectorSiteContainer> readAlignment(std::istream& input, std::shared_ptr<const Alphabet> alphabet) const;
+
+  std::unique_ptr<VectorSiteContainer> readAlignment(const std::string& path, std::shared_ptr<const Alphabet> alphabet) const;
+
+  /**
+   * @return The number of bits used to store a resolved state of an alphabet.
+   */
+  static unsigned int getNumberOfBitsPerState(const Alphabet& alphabet);
+
+  /**
+   * @brief Get the alignment to analyse, in the packed format or in any
+   * format supported by SequenceApplicationTools::getSiteContainer.
+   *
+   * The packed format is selected with input.sequence.format=Packed.
+   * Sequences and sites are then selected as for the other formats, with
+   * input.sequence.keep_names, input.sequence.remove_names and
+   * input.site.selection.
+   */
+  static std::unique_ptr<VectorSiteContainer> getSiteContainer(
+    std::shared_ptr<const Alphabet> alphabet,
+    const std::map<std::string, std::string>& params);
+};
+} // end of namespace bpp.
+
+#endif // BPPSUITE_PACKEDALIGNMENT_H
@@ -0,0 +1,140 @@
+//
+// File: ParallelDistanceEstimation.cpp
+// Created by: Bio++ Development Team
+// Created on: Oct Sun 18 2026
+//
+
+/*
+Copyright or © or Copr. Bio++ Development Team
+
+This software is a computer program whose purpose is to estimate
+phylogenies and evolutionary parameters from a dataset according to
+the maximum likelihood principle.
+
+This software is governed by the CeCILL  license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+*/
+
+#include "ParallelDistanceEstimation.h"
+#include "ParallelTools.h"
+
+// From bpp-core:
+#include <Bpp/App/ApplicationTools.h>
+
+// From bpp-seq:
+#include <Bpp/Seq/Sequence.h>
+
+// From bpp-phyl:
+#include <Bpp/Phyl/Distance/DistanceEstimation.h>
+
+using namespace bpp;
+using namespace std;
+
+unique_ptr<TriangularDistanceMatrix> ParallelDistanceEstimation::computeMatrix(
+  bool estimateParameters,
+  const ParameterList& parametersToIgnore,
+  bool singlePrecision) const
+{
+  size_t n = sites_->getNumberOfSequences();
+  vector<string> names = sites_->getSequenceNames();
+  auto matrix = make_unique<TriangularDistanceMatrix>(names, singlePrecision);
+  if (n < 2)
+    return matrix;
+
+  // Each thread has its own copies of the model and rate distribution,
+  // and its own estimation, reused for all the pairs it computes:
+  size_t nbWorkers = min(nbThreads_, n - 1);
+  vector<shared_ptr<BranchModelInterface>> models(nbWorkers);
+  vector<shared_ptr<DiscreteDistributionInterface>> rateDists(nbWorkers);
+  vector<shared_ptr<VectorSiteContainer>> pairs(nbWorkers);
+  vector<unique_ptr<DistanceEstimation>> estimations(nbWorkers);
+  auto alphabet = sites_->getAlphabet();
+  for (size_t w = 0; w < nbWorkers; ++w)
+  {
+    models[w] = shared_ptr<BranchModelInterface>(model_->clone());
+    rateDists[w] = shared_ptr<DiscreteDistributionInterface>(rateDist_->clone());
+    pairs[w] = make_shared<VectorSiteContainer>(alphabet);
+    auto seqi = make_unique<Sequence>(sites_->sequence(0));
+    pairs[w]->addSequence(names[0], seqi);
+    auto seqj = make_unique<Sequence>(sites_->sequence(1));
+    pairs[w]->addSequence(names[1], seqj);
+    estimations[w] = make_unique<DistanceEstimation>(models[w], rateDists[w], pairs[w], 0, false);
+  }
+  ParameterList initModelParameters = model_->getParameters();
+  ParameterList initRateParameters = rateDist_->getParameters();
+  ParameterList parametersToEstimate;
+  if (estimateParameters)
+  {
+    parametersToEstimate = model_->getIndependentParameters();
+    parametersToEstimate.addParameters(rateDist_->getIndependentParameters());
+    parametersToEstimate.deleteParameters(parametersToIgnore.getParameterNames(), false);
+  }
+
+  size_t nbPairs = n * (n - 1) / 2;
+  size_t nbPairsDone = 0;
+  if (verbose_)
+    ApplicationTools::displayTask("Compute pairwise distances", true);
+
+  unique_ptr<ParallelTools::WarningsOff> warningsOff;
+  if (nbWorkers > 1)
+    warningsOff = make_unique<ParallelTools::WarningsOff>();
+
+  ParallelTools::parallelFor(n - 1, nbThreads_,
+    [&](size_t i, size_t w)
+    {
+      auto& model = models[w];
+      auto& rateDist = rateDists[w];
+      auto& pair = pairs[w];
+      auto& estimation = estimations[w];
+      auto seqi = make_unique<Sequence>(sites_->sequence(i));
+      pair->setSequence(0, seqi);
+      for (size_t j = i + 1; j < n; ++j)
+      {
+        auto seqj = make_unique<Sequence>(sites_->sequence(j));
+        pair->setSequence(1, seqj);
+
+        // All pairs start from the same parameter values:
+        model->matchParametersValues(initModelParameters);
+        rateDist->matchParametersValues(initRateParameters);
+        if (estimateParameters)
+          estimation->setAdditionalParameters(parametersToEstimate);
+
+        estimation->setData(pair);
+        estimation->computeMatrix();
+        matrix->set(i, j, (*estimation->getMatrix())(0, 1));
+      }
+    },
+    [&](size_t i)
+    {
+      nbPairsDone += n - 1 - i;
+      if (verbose_)
+        ApplicationTools::displayGauge(nbPairsDone, nbPairs, '=');
+    });
+
+  if (verbose_)
+    ApplicationTools::displayTaskDone();
+  return matrix;
+}
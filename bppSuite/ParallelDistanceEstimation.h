@@ -0,0 +1,122 @@
+//
+// File: ParallelDistanceEstimation.h
+// Created by: Bio++ Development Team
+// Created on: Oct Sun 18 2026
+//
+
+/*
+Copyright or © or Copr. Bio++ Development Team
+
+This software is a computer program whose purpose is to estimate
+phylogenies and evolutionary parameters from a dataset according to
+the maximum likelihood principle.
+
+This software is governed by the CeCILL  license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+*/
+
+#ifndef BPPSUITE_PARALLELDISTANCEESTIMATION_H
+#define BPPSUITE_PARALLELDISTANCEESTIMATION_H
+
+#include "TriangularDistanceMatrix.h"
+
+// From the STL:
+#include <memory>
+
+// From bpp-core:
+#include <Bpp/Numeric/ParameterList.h>
+#include <Bpp/Numeric/Prob/DiscreteDistribution.h>
+
+// From bpp-seq:
+#include <Bpp/Seq/Container/VectorSiteContainer.h>
+
+// From bpp-phyl:
+#include <Bpp/Phyl/Model/SubstitutionModel.h>
+
+namespace bpp
+{
+/**
+ * @brief Estimate a matrix of pairwise distances on several threads.
+ *
+ * Each thread has one DistanceEstimation, on an alignment of two
+ * sequences, which is reused for all the pairs it computes: sequences are
+ * swapped, and model and rate distribution parameters are reset to their
+ * initial values before each pair. Rows of the matrix are handed out one
+ * at a time to the threads, first row first, so that threads stay busy
+ * until the end whatever the cost of each pair.
+ *
+ * With several threads, warnings of the estimations are discarded, see
+ * ParallelTools::WarningsOff.
+ */
+class ParallelDistanceEstimation
+{
+private:
+  std::shared_ptr<const BranchModelInterface> model_;
+  std::shared_ptr<const DiscreteDistributionInterface> rateDist_;
+  std::shared_ptr<const VectorSiteContainer> sites_;
+  size_t nbThreads_;
+  size_t verbose_;
+
+public:
+  /**
+   * @param model     The substitution model, copied by each thread.
+   * @param rateDist  The rate distribution, copied by each thread.
+   * @param sites     The sequences to compare.
+   * @param nbThreads Number of threads to use.
+   * @param verbose   If positive, progress is displayed in a gauge.
+   */
+  ParallelDistanceEstimation(
+    std::shared_ptr<const BranchModelInterface> model,
+    std::shared_ptr<const DiscreteDistributionInterface> rateDist,
+    std::shared_ptr<const VectorSiteContainer> sites,
+    size_t nbThreads,
+    size_t verbose = 1) :
+    model_(model),
+    rateDist_(rateDist),
+    sites_(sites),
+    nbThreads_(nbThreads),
+    verbose_(verbose)
+  {}
+
+public:
+  /**
+   * @brief Compute the matrix of pairwise distances.
+   *
+   * @param estimateParameters If true, model and rate distribution
+   * parameters are estimated independently for each pair, as with
+   * OptimizationTools::DISTANCEMETHOD_PAIRWISE.
+   * @param parametersToIgnore Parameters not to estimate.
+   * @param singlePrecision If true, distances are stored in single
+   * precision.
+   */
+  std::unique_ptr<TriangularDistanceMatrix> computeMatrix(
+    bool estimateParameters = false,
+    const ParameterList& parametersToIgnore = ParameterList(),
+    bool singlePrecision = false) const;
+};
+} // end of namespace bpp.
+
+#endif // BPPSUITE_PARALLELDISTANCEESTIMATION_H
@@ -0,0 +1,226 @@
+//
+// File: ParallelTools.h
+// Created by: Bio++ Development Team
+// Created on: Oct Sun 18 2026
+//
+
+/*
+Copyright or © or Copr. Bio++ Development Team
+
+This software is a computer program whose purpose is to estimate
+phylogenies and evolutionary parameters from a dataset according to
+the maximum likelihood principle.
+
+This software is governed by the CeCILL  license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+*/
+
+#ifndef BPPSUITE_PARALLELTOOLS_H
+#define BPPSUITE_PARALLELTOOLS_H
+
+// From the STL:
+#include <map>
+#include <string>
+#include <vector>
+#include <deque>
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <exception>
+#include <condition_variable>
+#include <memory>
+
+// From bpp-core:
+#include <Bpp/App/ApplicationTools.h>
+#include <Bpp/Io/OutputStream.h>
+
+namespace bpp
+{
+/**
+ * @brief Tools to run independent tasks on several threads.
+ *
+ * Tasks are handed out one at a time to the worker threads, so that
+ * workers which get cheap tasks simply take more of them, whatever the
+ * differences in cost between tasks.
+ *
+ * Bio++ objects are in general not thread-safe: each worker must use its
+ * own copies of the objects it modifies, and random numbers must be drawn
+ * in the calling thread, since they all come from the same default
+ * generator.
+ */
+class ParallelTools
+{
+public:
+  /**
+   * @brief Get the number of worker threads from option number_of_threads.
+   *
+   * The default is 1, that is no additional thread. 0 means one thread per
+   * available core.
+   */
+  static size_t getNumberOfThreads(const std::map<std::string, std::string>& params, const std::string& suffix = "", bool suffixIsOptional = true, bool verbose = true, int warn = 1)
+  {
+    size_t nbThreads = ApplicationTools::getParameter<size_t>("number_of_threads", params, 1, suffix, suffixIsOptional, warn);
+    if (nbThreads == 0)
+      nbThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    if (verbose)
+      ApplicationTools::displayResult("Number of threads", nbThreads);
+    return nbThreads;
+  }
+
+  /**
+   * @brief Run task(i, w) for all i in [0, n), with w the index of the
+   * worker running it.
+   *
+   * onDone(i) is called in the calling thread after task i is finished, in
+   * the order in which tasks finish. It can be used to display progress or
+   * to write results. With a single thread, tasks are run in order in the
+   * calling thread.
+   *
+   * The first exception thrown by a task or by onDone stops the
+   * distribution of tasks and is rethrown once all workers are done.
+   */
+  template<class Task, class OnDone>
+  static void parallelFor(size_t n, size_t nbThreads, Task task, OnDone onDone)
+  {
+    if (nbThreads <= 1 || n <= 1)
+    {
+      for (size_t i = 0; i < n; ++i)
+      {
+        task(i, 0);
+        onDone(i);
+      }
+      return;
+    }
+    nbThreads = std::min(nbThreads, n);
+
+    std::atomic<size_t> next(0);
+    std::atomic<bool> stop(false);
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<size_t> done;
+    size_t nbRunning = nbThreads;
+    std::exception_ptr error = nullptr;
+
+    auto worker = [&](size_t w) {
+      while (!stop)
+      {
+        size_t i = next++;
+        if (i >= n)
+          break;
+        try
+        {
+          task(i, w);
+        }
+        catch (...)
+        {
+          std::lock_guard<std::mutex> lock(mutex);
+          if (!error)
+            error = std::current_exception();
+          stop = true;
+          break;
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        done.push_back(i);
+        cv.notify_one();
+      }
+      std::lock_guard<std::mutex> lock(mutex);
+      nbRunning--;
+      cv.notify_one();
+    };
+
+    std::vector<std::thread> threads;
+    for (size_t w = 0; w < nbThreads; ++w)
+      threads.push_back(std::thread(worker, w));
+
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true)
+    {
+      cv.wait(lock, [&] { return !done.empty() || nbRunning == 0; });
+      if (done.empty())
+        break;
+      size_t i = done.front();
+      done.pop_front();
+      if (stop)
+        continue;
+      lock.unlock();
+      try
+      {
+        onDone(i);
+      }
+      catch (...)
+      {
+        lock.lock();
+        if (!error)
+          error = std::current_exception();
+        stop = true;
+        continue;
+      }
+      lock.lock();
+    }
+    lock.unlock();
+
+    for (auto& t : threads)
+      t.join();
+    if (error)
+      std::rethrow_exception(error);
+  }
+
+  template<class Task>
+  static void parallelFor(size_t n, size_t nbThreads, Task task)
+  {
+    parallelFor(n, nbThreads, task, [](size_t) {});
+  }
+
+  /**
+   * @brief Discard the warnings of ApplicationTools as long as it lives.
+   *
+   * Bio++ functions write their warnings to ApplicationTools::warning,
+   * which cannot be shared between threads. Warnings are discarded while
+   * such functions run on several threads, and the previous stream is
+   * restored on destruction.
+   */
+  class WarningsOff
+  {
+  private:
+    std::shared_ptr<OutputStream> warning_;
+
+  public:
+    WarningsOff() :
+      warning_(ApplicationTools::warning)
+    {
+      ApplicationTools::warning = std::make_shared<NullOutputStream>();
+    }
+
+    WarningsOff(const WarningsOff&) = delete;
+    WarningsOff& operator=(const WarningsOff&) = delete;
+
+    ~WarningsOff() { ApplicationTools::warning = warning_; }
+  };
+};
+} // end of namespace bpp.
+
+#endif // BPPSUITE_PARALLELTOOLS_H
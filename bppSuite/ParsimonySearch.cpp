@@ -0,0 +1,373 @@
+//
+// File: ParsimonySearch.cpp
+// Created by: Bio++ Development Team
+// Created on: Oct Sun 18 2026
+//
+
+/*
+Copyright or © or Copr. Bio++ Development Team
+
+This software is a computer program whose purpose is to estimate
+phylogenies and evolutionary parameters from a dataset according to
+the maximum parsimony principle.
+
+This software is governed by the CeCILL  license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+*/
+
+#include "ParsimonySearch.h"
+
+// From the STL:
+#include <algorithm>
+#include <numeric>
+#include <tuple>
+
+// From bpp-core:
+#include <Bpp/Exceptions.h>
+
+using namespace bpp;
+using namespace std;
+
+/******************************************************************************/
+
+ParsimonySearch::ParsimonySearch(const FitchParsimony& parsimony) :
+  parsimony_(parsimony),
+  nbLeaves_(parsimony.getNames().size()),
+  size_(parsimony.getSize()),
+  neighbors_(),
+  sets_(),
+  costs_(),
+  branches_(),
+  score_(0),
+  buffer_(parsimony.getSize()),
+  savedIndices_(),
+  savedSets_(),
+  nbUpdates_(0),
+  nbMoves_(0)
+{
+  if (nbLeaves_ < 3)
+    throw Exception("ParsimonySearch: at least three sequences are needed.");
+  size_t nbNodes = 2 * nbLeaves_ - 2;
+  neighbors_.assign(nbNodes, {{-1, -1, -1}});
+  sets_.resize(3 * nbNodes * size_);
+  costs_.assign(3 * nbNodes, 0);
+  for (size_t i = 0; i < nbLeaves_; ++i)
+  {
+    const auto& leafSets = parsimony.getLeafStateSets(i);
+    std::copy(leafSets.begin(), leafSets.end(), sets_.begin() + static_cast<ptrdiff_t>(3 * i * size_));
+  }
+}
+
+/******************************************************************************/
+
+size_t ParsimonySearch::getSlot_(int u, int v) const
+{
+  const auto& neighbors = neighbors_[static_cast<size_t>(u)];
+  for (size_t k = 0; k < 3; ++k)
+  {
+    if (neighbors[k] == v)
+      return k;
+  }
+  throw Exception("ParsimonySearch::getSlot_: nodes are not neighbors.");
+}
+
+/******************************************************************************/
+
+void ParsimonySearch::replaceNeighbor_(int u, int oldNeighbor, int newNeighbor)
+{
+  neighbors_[static_cast<size_t>(u)][getSlot_(u, oldNeighbor)] = newNeighbor;
+}
+
+/******************************************************************************/
+
+void ParsimonySearch::compute_(int u, int v)
+{
+  // The sets of leaves never change.
+  if (static_cast<size_t>(u) < nbLeaves_)
+    return;
+  size_t k = getSlot_(u, v);
+  const auto& neighbors = neighbors_[static_cast<size_t>(u)];
+  int a = neighbors[(k + 1) % 3];
+  int b = neighbors[(k + 2) % 3];
+  size_t index = 3 * static_cast<size_t>(u) + k;
+  costs_[index] = getCost_(a, u) + getCost_(b, u)
+      + parsimony_.combine(getSets_(a, u), getSets_(b, u), &sets_[index * size_]);
+  nbUpdates_++;
+}
+
+/******************************************************************************/
+
+void ParsimonySearch::collectBranches_(int u, int v)
+{
+  // Breadth-first order, from both ends of the starting branch, so that
+  // parents come before their sons:
+  branches_.clear();
+  branches_.push_back({ u, v });
+  branches_.push_back({ v, u });
+  for (size_t i = 0; i < branches_.size(); ++i)
+  {
+    int w = branches_[i].first;
+    if (static_cast<size_t>(w) < nbLeaves_)
+      continue;
+    for (int x : neighbors_[static_cast<size_t>(w)])
+    {
+      if (x != branches_[i].second)
+        branches_.push_back({ x, w });
+    }
+  }
+}
+
+/******************************************************************************/
+
+void ParsimonySearch::update_(int u, int v)
+{
+  collectBranches_(u, v);
+
+  // Sets of the subtrees below each node, then of the rest of the tree:
+  for (size_t i = branches_.size(); i > 0; --i)
+    compute_(branches_[i - 1].first, branches_[i - 1].second);
+  for (size_t i = 2; i < branches_.size(); ++i)
+    compute_(branches_[i].second, branches_[i].first);
+
+  score_ = getCost_(u, v) + getCost_(v, u) + parsimony_.getCost(getSets_(u, v), getSets_(v, u));
+}
+
+/******************************************************************************/
+
+void ParsimonySearch::propagate_(int u, int v)
+{
+  vector<pair<int, int>> changed = { { u, v } };
+  while (!changed.empty())
+  {
+    int x = changed.back().first;
+    int y = changed.back().second;
+    changed.pop_back();
+    if (static_cast<size_t>(y) < nbLeaves_)
+      continue;
+    const auto& neighbors = neighbors_[static_cast<size_t>(y)];
+    size_t ky = getSlot_(y, x);
+    for (size_t i = 1; i < 3; ++i)
+    {
+      // Sets of the side of y seen from w, which contains the side of x:
+      int w = neighbors[(ky + i) % 3];
+      int z = neighbors[(ky + 3 - i) % 3];
+      parsimony_.combine(getSets_(x, y), getSets_(z, y), buffer_.data());
+      nbUpdates_++;
+      size_t index = 3 * static_cast<size_t>(y) + getSlot_(y, w);
+      auto sets = sets_.begin() + static_cast<ptrdiff_t>(index * size_);
+      if (std::equal(buffer_.begin(), buffer_.end(), sets))
+        continue;
+      savedIndices_.push_back(index);
+      savedSets_.insert(savedSets_.end(), sets, sets + static_cast<ptrdiff_t>(size_));
+      std::copy(buffer_.begin(), buffer_.end(), sets);
+      changed.push_back({ y, w });
+    }
+  }
+}
+
+/******************************************************************************/
+
+void ParsimonySearch::restore_()
+{
+  for (size_t i = savedIndices_.size(); i > 0; --i)
+  {
+    auto saved = savedSets_.begin() + static_cast<ptrdiff_t>((i - 1) * size_);
+    std::copy(saved, saved + static_cast<ptrdiff_t>(size_), sets_.begin() + static_cast<ptrdiff_t>(savedIndices_[i - 1] * size_));
+  }
+  savedIndices_.clear();
+  savedSets_.clear();
+}
+
+/******************************************************************************/
+
+unsigned int ParsimonySearch::buildRandomAdditionTree(std::mt19937& generator)
+{
+  vector<int> order(nbLeaves_);
+  iota(order.begin(), order.end(), 0);
+  shuffle(order.begin(), order.end(), generator);
+
+  for (auto& neighbors : neighbors_)
+    neighbors = {{-1, -1, -1}};
+  int next = static_cast<int>(nbLeaves_);
+  for (size_t i = 0; i < 3; ++i)
+  {
+    neighbors_[nbLeaves_][i] = order[i];
+    neighbors_[static_cast<size_t>(order[i])][0] = next;
+  }
+  next++;
+  update_(order[0], static_cast<int>(nbLeaves_));
+
+  for (size_t i = 3; i < nbLeaves_; ++i)
+  {
+    int x = order[i];
+    const uint64_t* leafSets = &sets_[3 * static_cast<size_t>(x) * size_];
+
+    // The first branch of the list is the second one reversed:
+    unsigned int bestCost = 0;
+    size_t best = 0;
+    size_t nbTies = 0;
+    for (size_t j = 1; j < branches_.size(); ++j)
+    {
+      int w = branches_[j].first;
+      int p = branches_[j].second;
+      unsigned int cost = parsimony_.getInsertionCost(getSets_(w, p), getSets_(p, w), leafSets);
+      if (nbTies == 0 || cost < bestCost)
+      {
+        bestCost = cost;
+        best = j;
+        nbTies = 1;
+      }
+      else if (cost == bestCost)
+      {
+        nbTies++;
+        if (uniform_int_distribution<size_t>(0, nbTies - 1)(generator) == 0)
+          best = j;
+      }
+    }
+
+    int w = branches_[best].first;
+    int p = branches_[best].second;
+    int m = next++;
+    neighbors_[static_cast<size_t>(m)] = {{w, p, x}};
+    replaceNeighbor_(w, p, m);
+    replaceNeighbor_(p, w, m);
+    neighbors_[static_cast<size_t>(x)][0] = m;
+    update_(x, m);
+  }
+  return score_;
+}
+
+/******************************************************************************/
+
+unsigned int ParsimonySearch::optimizeSPR()
+{
+  int nbNodes = static_cast<int>(neighbors_.size());
+  bool improved = true;
+  while (improved)
+  {
+    improved = false;
+    for (int s = 0; s < nbNodes; ++s)
+    {
+      for (size_t k = 0; k < 3; ++k)
+      {
+        // Subtree on the side of s, attached to the internal node p:
+        int p = neighbors_[static_cast<size_t>(s)][k];
+        if (p < 0 || static_cast<size_t>(p) < nbLeaves_)
+          continue;
+        size_t kp = getSlot_(p, s);
+        int a = neighbors_[static_cast<size_t>(p)][(kp + 1) % 3];
+        int b = neighbors_[static_cast<size_t>(p)][(kp + 2) % 3];
+        unsigned int score = score_;
+
+        // Prune it. The sets of the subtree itself and those of the sides
+        // of a and b seen from each other stay valid, and so does the score
+        // of the rest of the tree. Only the sets which contained the
+        // subtree change, and only as long as they differ from the old
+        // ones.
+        replaceNeighbor_(a, p, b);
+        replaceNeighbor_(b, p, a);
+        unsigned int rest = getCost_(a, b) + getCost_(b, a) + parsimony_.getCost(getSets_(a, b), getSets_(b, a))
+            + getCost_(s, p);
+        const uint64_t* subtree = getSets_(s, p);
+
+        size_t best = 0;
+        if (rest < score)
+        {
+          propagate_(a, b);
+          propagate_(b, a);
+          collectBranches_(a, b);
+          for (size_t j = 1; j < branches_.size(); ++j)
+          {
+            int w = branches_[j].first;
+            int q = branches_[j].second;
+            if ((w == a && q == b) || (w == b && q == a))
+              continue;
+            nbMoves_++;
+            unsigned int cost = rest + parsimony_.getInsertionCost(getSets_(w, q), getSets_(q, w), subtree, score - rest);
+            if (cost < score)
+            {
+              score = cost;
+              best = j;
+            }
+          }
+        }
+
+        // Regraft it on the best branch, or back in place with the old
+        // sets:
+        if (best > 0)
+        {
+          a = branches_[best].first;
+          b = branches_[best].second;
+          neighbors_[static_cast<size_t>(p)][(kp + 1) % 3] = a;
+          neighbors_[static_cast<size_t>(p)][(kp + 2) % 3] = b;
+          improved = true;
+        }
+        replaceNeighbor_(a, b, p);
+        replaceNeighbor_(b, a, p);
+        if (best > 0)
+        {
+          savedIndices_.clear();
+          savedSets_.clear();
+          update_(p, s);
+        }
+        else
+          restore_();
+      }
+    }
+  }
+  return score_;
+}
+
+/******************************************************************************/
+
+std::unique_ptr<TreeTemplate<Node>> ParsimonySearch::getTree() const
+{
+  const auto& names = parsimony_.getNames();
+  int root = neighbors_[0][0];
+  Node* rootNode = new Node(root);
+  vector<tuple<int, int, Node*>> stack = { make_tuple(root, -1, rootNode) };
+  while (!stack.empty())
+  {
+    int u = get<0>(stack.back());
+    int parent = get<1>(stack.back());
+    Node* node = get<2>(stack.back());
+    stack.pop_back();
+    for (int w : neighbors_[static_cast<size_t>(u)])
+    {
+      if (w == parent)
+        continue;
+      if (static_cast<size_t>(w) < nbLeaves_)
+        node->addSon(new Node(w, names[static_cast<size_t>(w)]));
+      else
+      {
+        Node* son = new Node(w);
+        node->addSon(son);
+        stack.push_back(make_tuple(w, u, son));
+      }
+    }
+  }
+  return unique_ptr<TreeTemplate<Node>>(new TreeTemplate<Node>(rootNode));
+}
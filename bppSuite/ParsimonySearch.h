@@ -0,0 +1,207 @@
+//
+// File: ParsimonySearch.h
+// Created by: Bio++ Development Team
+// Created on: Oct Sun 18 2026
+//
+
+/*
+Copyright or © or Copr. Bio++ Development Team
+
+This software is a computer program whose purpose is to estimate
+phylogenies and evolutionary parameters from a dataset according to
+the maximum parsimony principle.
+
+This software is governed by the CeCILL  license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+*/
+
+#ifndef BPPSUITE_PARSIMONYSEARCH_H
+#define BPPSUITE_PARSIMONYSEARCH_H
+
+#include "FitchParsimony.h"
+
+// From the STL:
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+// From bpp-phyl:
+#include <Bpp/Phyl/Tree/TreeTemplate.h>
+
+namespace bpp
+{
+/**
+ * @brief Search for maximum parsimony trees by stepwise addition and
+ * subtree pruning and regrafting (SPR).
+ *
+ * The tree is unrooted and bifurcating. Each branch has two state sets,
+ * one for the subtree on each side, so that the cost of attaching a leaf
+ * or a subtree on any branch is a single FitchParsimony::getInsertionCost
+ * call. All the state sets of a tree are computed in two passes, from and
+ * toward a branch. When a subtree is pruned to evaluate its SPR moves,
+ * only the sets on the paths from the pruning point are recomputed, up to
+ * the first unchanged one, and put back afterwards.
+ *
+ * A search only reads the FitchParsimony engine: several searches can run
+ * at the same time on the same engine, each with its own random
+ * generator.
+ */
+class ParsimonySearch
+{
+private:
+  const FitchParsimony& parsimony_;
+  size_t nbLeaves_;
+  size_t size_;
+
+  /**
+   * @brief Neighbors of each node, or -1.
+   *
+   * Leaves are the nodes 0 to nbLeaves_ - 1, in the order of the names of
+   * the engine, and only have a first neighbor.
+   */
+  std::vector<std::array<int, 3>> neighbors_;
+
+  /**
+   * @brief State sets of the subtree on the side of node u of the branch
+   * to its k-th neighbor, at index (3u + k) * size_.
+   */
+  std::vector<uint64_t> sets_;
+
+  /**
+   * @brief Number of changes within each of these subtrees.
+   */
+  std::vector<unsigned int> costs_;
+
+  /**
+   * @brief Branches of the tree, as (node, parent) pairs from the last
+   * update, parents first. The first two are the starting branch, in both
+   * directions.
+   */
+  std::vector<std::pair<int, int>> branches_;
+
+  unsigned int score_;
+
+  std::vector<uint64_t> buffer_;
+
+  /**
+   * @brief Sets overwritten while a subtree is pruned, and their index,
+   * to put them back if the subtree does not move.
+   */
+  std::vector<size_t> savedIndices_;
+  std::vector<uint64_t> savedSets_;
+
+  size_t nbUpdates_;
+  size_t nbMoves_;
+
+public:
+  /**
+   * @throw Exception if there are less than three sequences.
+   */
+  ParsimonySearch(const FitchParsimony& parsimony);
+
+public:
+  unsigned int getScore() const { return score_; }
+
+  /**
+   * @return The number of state sets computed so far, that is of calls
+   * to FitchParsimony::combine.
+   */
+  size_t getNumberOfUpdates() const { return nbUpdates_; }
+
+  /**
+   * @return The number of SPR moves evaluated so far.
+   */
+  size_t getNumberOfEvaluatedMoves() const { return nbMoves_; }
+
+  /**
+   * @brief Build a tree by adding the leaves in a random order, each one
+   * on the branch where it costs the least. Ties are broken at random.
+   *
+   * @return The score of the tree.
+   */
+  unsigned int buildRandomAdditionTree(std::mt19937& generator);
+
+  /**
+   * @brief Move subtrees to the branches where they cost the least, as
+   * long as this lowers the score.
+   *
+   * @return The score of the tree.
+   */
+  unsigned int optimizeSPR();
+
+  /**
+   * @return The current tree, with a trifurcating root and no branch
+   * lengths.
+   */
+  std::unique_ptr<TreeTemplate<Node>> getTree() const;
+
+private:
+  const uint64_t* getSets_(int u, int v) const { return &sets_[(3 * static_cast<size_t>(u) + getSlot_(u, v)) * size_]; }
+
+  unsigned int getCost_(int u, int v) const { return costs_[3 * static_cast<size_t>(u) + getSlot_(u, v)]; }
+
+  size_t getSlot_(int u, int v) const;
+
+  void replaceNeighbor_(int u, int oldNeighbor, int newNeighbor);
+
+  /**
+   * @brief Compute the state sets of the side of u of the branch to v,
+   * from the sets of the other neighbors of u.
+   */
+  void compute_(int u, int v);
+
+  /**
+   * @brief List the branches of the tree containing the branch between u
+   * and v, in branches_.
+   */
+  void collectBranches_(int u, int v);
+
+  /**
+   * @brief Compute all the state sets of the tree containing the branch
+   * between u and v, and its score.
+   */
+  void update_(int u, int v);
+
+  /**
+   * @brief Recompute the sets which contain the side of u of the branch
+   * to v, after it changed, saving the old ones.
+   *
+   * Recomputation stops along a path as soon as a set is unchanged.
+   * Subtree costs are not updated: this is only used to evaluate moves.
+   */
+  void propagate_(int u, int v);
+
+  /**
+   * @brief Put back the sets saved by propagate_.
+   */
+  void restore_();
+};
+} // end of namespace bpp.
+
+#endif // BPPSUITE_PARSIMONYSEARCH_H
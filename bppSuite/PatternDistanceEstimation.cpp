@@ -0,0 +1,370 @@
+//
+// File: PatternDistanceEstimation.cpp
+// Created by: Bio++ Development Team
+// Created on: Oct Sun 18 2026
+//
+
+/*
+Copyright or © or Copr. Bio++ Development Team
+
+This software is a computer program whose purpose is to estimate
+phylogenies and evolutionary parameters from a dataset according to
+the maximum likelihood principle.
+
+This software is governed by the CeCILL  license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+*/
+
+#include "MinimizationTools.h"
+#include "ParallelTools.h"
+#include "PatternDistanceEstimation.h"
+
+// From the STL:
+#include <cmath>
+#include <algorithm>
+
+// From bpp-core:
+#include <Bpp/App/ApplicationTools.h>
+#include <Bpp/Exceptions.h>
+#include <Bpp/Numeric/NumConstants.h>
+
+using namespace bpp;
+using namespace std;
+
+const double PatternDistanceEstimation::MIN_DISTANCE = 0.000001;
+const double PatternDistanceEstimation::MAX_DISTANCE = 10000.;
+const double PatternDistanceEstimation::TOLERANCE = 0.000001;
+const double PatternDistanceEstimation::WARM_START_RANGE = log(4.);
+
+/******************************************************************************/
+
+PatternDistanceEstimation::PatternDistanceEstimation(const SiteContainerInterface& sites) :
+  alphabet_(sites.getAlphabet()),
+  names_(sites.getSequenceNames()),
+  codes_(sites.getNumberOfSequences()),
+  counts_(),
+  nbSites_(sites.getNumberOfSites()),
+  aliases_()
+{
+  size_t n = names_.size();
+  map<vector<int>, size_t> patternIndex;
+  vector<int> column(n);
+  for (size_t k = 0; k < nbSites_; ++k)
+  {
+    const auto& site = sites.site(k);
+    for (size_t i = 0; i < n; ++i)
+      column[i] = site[i];
+    auto it = patternIndex.find(column);
+    if (it == patternIndex.end())
+    {
+      patternIndex[column] = counts_.size();
+      counts_.push_back(1);
+      for (size_t i = 0; i < n; ++i)
+        codes_[i].push_back(column[i]);
+    }
+    else
+      counts_[it->second]++;
+  }
+
+  // States that partially resolved characters stand for; gaps and fully
+  // unknown characters are not informative.
+  size_t K = alphabet_->getSize();
+  int size = static_cast<int>(K);
+  for (const auto& seqCodes : codes_)
+  {
+    for (int code : seqCodes)
+    {
+      if ((code >= 0 && code < size) || aliases_.find(code) != aliases_.end() || alphabet_->isGap(code))
+        continue;
+      vector<int> alias = alphabet_->getAlias(code);
+      if (alias.size() < K)
+      {
+        vector<size_t>& states = aliases_[code];
+        for (int a : alias)
+          states.push_back(static_cast<size_t>(a));
+      }
+    }
+  }
+}
+
+/******************************************************************************/
+
+bool PatternDistanceEstimation::isCompatible(const BranchModelInterface& model) const
+{
+  return dynamic_cast<const TransitionModelInterface*>(&model)
+         && model.getNumberOfStates() == alphabet_->getSize();
+}
+
+/******************************************************************************/
+
+vector<unsigned int> PatternDistanceEstimation::drawBootstrapCounts(mt19937& generator) const
+{
+  // Multinomial draw, as a sequence of binomial draws:
+  size_t nbPatterns = counts_.size();
+  vector<unsigned int> counts(nbPatterns, 0);
+  unsigned int remaining = static_cast<unsigned int>(nbSites_);
+  double remainingMass = static_cast<double>(nbSites_);
+  for (size_t p = 0; p < nbPatterns && remaining > 0; ++p)
+  {
+    if (p == nbPatterns - 1)
+    {
+      counts[p] = remaining;
+      break;
+    }
+    double prob = min(1., static_cast<double>(counts_[p]) / remainingMass);
+    binomial_distribution<unsigned int> binomial(remaining, prob);
+    counts[p] = binomial(generator);
+    remaining -= counts[p];
+    remainingMass -= static_cast<double>(counts_[p]);
+  }
+  return counts;
+}
+
+/******************************************************************************/
+
+map<int, double> PatternDistanceEstimation::getFrequencies(const vector<unsigned int>& counts, double pseudoCount) const
+{
+  // Same estimator as TransitionModelInterface::setFreqFromData: unresolved
+  // characters are spread over the states they stand for, and gaps are
+  // ignored.
+  int size = static_cast<int>(alphabet_->getSize());
+  vector<double> freqs(static_cast<size_t>(size), 0.);
+  map<int, vector<int>> aliases;
+  for (const auto& seqCodes : codes_)
+  {
+    for (size_t p = 0; p < seqCodes.size(); ++p)
+    {
+      int code = seqCodes[p];
+      if (counts[p] == 0)
+        continue;
+      if (code >= 0 && code < size)
+        freqs[static_cast<size_t>(code)] += counts[p];
+      else if (!alphabet_->isGap(code))
+      {
+        auto it = aliases.find(code);
+        if (it == aliases.end())
+          it = aliases.emplace(code, alphabet_->getAlias(code)).first;
+        double weight = counts[p] / static_cast<double>(it->second.size());
+        for (int a : it->second)
+          freqs[static_cast<size_t>(a)] += weight;
+      }
+    }
+  }
+  double total = 0.;
+  for (auto& f : freqs)
+  {
+    f += pseudoCount;
+    total += f;
+  }
+  map<int, double> frequencies;
+  for (int a = 0; a < size; ++a)
+    frequencies[a] = total > 0. ? freqs[static_cast<size_t>(a)] / total : 1. / size;
+  return frequencies;
+}
+
+/******************************************************************************/
+
+void PatternDistanceEstimation::computeRow_(
+  size_t i,
+  const TransitionModelInterface& model,
+  const DiscreteDistributionInterface& rateDist,
+  const vector<unsigned int>& counts,
+  const TriangularDistanceMatrix* previous,
+  TriangularDistanceMatrix& matrix) const
+{
+  size_t n = names_.size();
+  size_t K = alphabet_->getSize();
+  int size = static_cast<int>(K);
+  auto isInformative = [&](int code) {
+      return (code >= 0 && code < size) || aliases_.find(code) != aliases_.end();
+    };
+
+  const vector<double>& freqs = model.getFrequencies();
+  size_t nbClasses = rateDist.getNumberOfCategories();
+  vector<double> rates(nbClasses), probs(nbClasses);
+  for (size_t r = 0; r < nbClasses; ++r)
+  {
+    rates[r] = rateDist.getCategory(r);
+    probs[r] = rateDist.getProbability(r);
+  }
+
+  vector<double> pairCounts(K * K);
+  map<pair<int, int>, double> partialCounts;
+  vector<double> pbar(K * K);
+
+  auto computePbar = [&](double t) {
+      std::fill(pbar.begin(), pbar.end(), 0.);
+      for (size_t r = 0; r < nbClasses; ++r)
+      {
+        const Matrix<double>& pij = model.getPij_t(rates[r] * t);
+        for (size_t a = 0; a < K; ++a)
+          for (size_t b = 0; b < K; ++b)
+            pbar[a * K + b] += probs[r] * pij(a, b);
+      }
+    };
+
+  auto stateSet = [&](int code) {
+      return (code >= 0 && code < size) ? vector<size_t>(1, static_cast<size_t>(code)) : aliases_.at(code);
+    };
+
+  // Opposite of the log-likelihood of the pair counts, as a function of
+  // the logarithm of the distance:
+  auto negLogLik = [&](double x) {
+      computePbar(exp(x));
+      double ll = 0.;
+      for (size_t a = 0; a < K; ++a)
+        for (size_t b = 0; b < K; ++b)
+          if (pairCounts[a * K + b] > 0.)
+            ll += pairCounts[a * K + b] * log(max(freqs[a] * pbar[a * K + b], NumConstants::VERY_TINY()));
+      for (const auto& partial : partialCounts)
+      {
+        double lik = 0.;
+        for (size_t a : stateSet(partial.first.first))
+          for (size_t b : stateSet(partial.first.second))
+            lik += freqs[a] * pbar[a * K + b];
+        ll += partial.second * log(max(lik, NumConstants::VERY_TINY()));
+      }
+      return -ll;
+    };
+
+  double lower = log(MIN_DISTANCE);
+  double upper = log(MAX_DISTANCE);
+  for (size_t j = i + 1; j < n; ++j)
+  {
+    std::fill(pairCounts.begin(), pairCounts.end(), 0.);
+    partialCounts.clear();
+    double nbInformative = 0.;
+    const vector<int>& ci = codes_[i];
+    const vector<int>& cj = codes_[j];
+    for (size_t p = 0; p < counts.size(); ++p)
+    {
+      if (counts[p] == 0)
+        continue;
+      int a = ci[p];
+      int b = cj[p];
+      if (a >= 0 && a < size && b >= 0 && b < size)
+        pairCounts[static_cast<size_t>(a) * K + static_cast<size_t>(b)] += counts[p];
+      else if (isInformative(a) && isInformative(b))
+        partialCounts[make_pair(a, b)] += counts[p];
+      else
+        continue;
+      nbInformative += counts[p];
+    }
+
+    double d = MAX_DISTANCE;
+    if (nbInformative > 0.)
+    {
+      double x;
+      double start = previous ? (*previous)(i, j) : 0.;
+      if (start > MIN_DISTANCE && start < MAX_DISTANCE)
+      {
+        // Warm start: search close to the previous estimate first, and on
+        // the whole interval only if the optimum is at the edge.
+        double a = max(lower, log(start) - WARM_START_RANGE);
+        double b = min(upper, log(start) + WARM_START_RANGE);
+        x = MinimizationTools::brent(negLogLik, a, b, TOLERANCE, log(start));
+        double margin = 2. * TOLERANCE * (fabs(x) + 1.);
+        if ((a > lower && x - a < margin) || (b < upper && b - x < margin))
+          x = MinimizationTools::brent(negLogLik, lower, upper, TOLERANCE);
+      }
+      else
+        x = MinimizationTools::brent(negLogLik, lower, upper, TOLERANCE);
+      d = exp(x);
+    }
+    matrix.set(i, j, d);
+  }
+}
+
+/******************************************************************************/
+
+unique_ptr<TriangularDistanceMatrix> PatternDistanceEstimation::computeMatrix(
+  const TransitionModelInterface& model,
+  const DiscreteDistributionInterface& rateDist,
+  const vector<unsigned int>& counts,
+  bool singlePrecision) const
+{
+  if (model.getNumberOfStates() != alphabet_->getSize())
+    throw Exception("PatternDistanceEstimation::computeMatrix: the model must have one state per character of the alphabet.");
+  if (counts.size() != counts_.size())
+    throw Exception("PatternDistanceEstimation::computeMatrix: wrong number of pattern counts.");
+
+  auto matrix = make_unique<TriangularDistanceMatrix>(names_, singlePrecision);
+  for (size_t i = 0; i < names_.size(); ++i)
+    computeRow_(i, model, rateDist, counts, nullptr, *matrix);
+  return matrix;
+}
+
+/******************************************************************************/
+
+unique_ptr<TriangularDistanceMatrix> PatternDistanceEstimation::computeMatrix(
+  const TransitionModelInterface& model,
+  const DiscreteDistributionInterface& rateDist,
+  size_t nbThreads,
+  const TriangularDistanceMatrix* previous,
+  size_t verbose,
+  bool singlePrecision) const
+{
+  if (model.getNumberOfStates() != alphabet_->getSize())
+    throw Exception("PatternDistanceEstimation::computeMatrix: the model must have one state per character of the alphabet.");
+  if (previous && previous->size() != names_.size())
+    throw Exception("PatternDistanceEstimation::computeMatrix: the previous matrix does not have the right size.");
+
+  size_t n = names_.size();
+  auto matrix = make_unique<TriangularDistanceMatrix>(names_, singlePrecision);
+  if (n < 2)
+    return matrix;
+
+  // Each thread has its own copies of the model and rate distribution:
+  size_t nbWorkers = min(nbThreads, n - 1);
+  vector<unique_ptr<TransitionModelInterface>> models(nbWorkers);
+  vector<unique_ptr<DiscreteDistributionInterface>> rateDists(nbWorkers);
+  for (size_t w = 0; w < nbWorkers; ++w)
+  {
+    models[w] = unique_ptr<TransitionModelInterface>(model.clone());
+    rateDists[w] = unique_ptr<DiscreteDistributionInterface>(rateDist.clone());
+  }
+
+  size_t nbPairs = n * (n - 1) / 2;
+  size_t nbPairsDone = 0;
+  if (verbose)
+    ApplicationTools::displayTask("Compute pairwise distances", true);
+
+  ParallelTools::parallelFor(n - 1, nbThreads,
+    [&](size_t i, size_t w)
+    {
+      computeRow_(i, *models[w], *rateDists[w], counts_, previous, *matrix);
+    },
+    [&](size_t i)
+    {
+      nbPairsDone += n - 1 - i;
+      if (verbose)
+        ApplicationTools::displayGauge(nbPairsDone, nbPairs, '=');
+    });
+
+  if (verbose)
+    ApplicationTools::displayTaskDone();
+  return matrix;
+}
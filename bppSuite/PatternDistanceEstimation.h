@@ -0,0 +1,205 @@
+//
+// File: PatternDistanceEstimation.h
+// Created by: Bio++ Development Team
+// Created on: Oct Sun 18 2026
+//
+
+/*
+Copyright or © or Copr. Bio++ Development Team
+
+This software is a computer program whose purpose is to estimate
+phylogenies and evolutionary parameters from a dataset according to
+the maximum likelihood principle.
+
+This software is governed by the CeCILL  license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+*/
+
+#ifndef BPPSUITE_PATTERNDISTANCEESTIMATION_H
+#define BPPSUITE_PATTERNDISTANCEESTIMATION_H
+
+#include "TriangularDistanceMatrix.h"
+
+// From the STL:
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+// From bpp-core:
+#include <Bpp/Numeric/Prob/DiscreteDistribution.h>
+
+// From bpp-seq:
+#include <Bpp/Seq/Alphabet/Alphabet.h>
+#include <Bpp/Seq/Container/SiteContainer.h>
+
+// From bpp-phyl:
+#include <Bpp/Phyl/Model/SubstitutionModel.h>
+
+namespace bpp
+{
+/**
+ * @brief Maximum likelihood pairwise distances from weighted site patterns.
+ *
+ * The alignment is compressed once into its distinct site patterns. Any
+ * weighting of the patterns, like the multinomial counts of a bootstrap
+ * replicate, can then be analysed without building a new alignment: for
+ * each pair of sequences, the weights are summed into a matrix of state
+ * pair counts, and the distance is the branch length maximizing the
+ * likelihood of these counts, with model and rate distribution parameters
+ * kept fixed. The cost of a replicate thus depends on the number of
+ * patterns, not on the length of the alignment.
+ *
+ * Sites with a gap or a fully unknown character in one of the two
+ * sequences do not depend on the distance, and are ignored. Partially
+ * resolved characters are accounted for by summing over the states they
+ * stand for.
+ *
+ * The model must be a transition model with one state per resolved
+ * character of the alphabet.
+ */
+class PatternDistanceEstimation
+{
+private:
+  std::shared_ptr<const Alphabet> alphabet_;
+  std::vector<std::string> names_;
+
+  /**
+   * @brief Character codes of each pattern, sequence by sequence.
+   */
+  std::vector<std::vector<int>> codes_;
+
+  /**
+   * @brief Number of sites of the alignment with each pattern.
+   */
+  std::vector<unsigned int> counts_;
+  size_t nbSites_;
+
+  /**
+   * @brief States of the partially resolved characters of the alignment.
+   */
+  std::map<int, std::vector<size_t>> aliases_;
+
+public:
+  PatternDistanceEstimation(const SiteContainerInterface& sites);
+
+public:
+  std::shared_ptr<const Alphabet> getAlphabet() const { return alphabet_; }
+  const std::vector<std::string>& getSequenceNames() const { return names_; }
+  size_t getNumberOfSequences() const { return names_.size(); }
+  size_t getNumberOfPatterns() const { return counts_.size(); }
+  size_t getNumberOfSites() const { return nbSites_; }
+  const std::vector<unsigned int>& getPatternCounts() const { return counts_; }
+
+  /**
+   * @return The character codes of sequence i, pattern by pattern.
+   */
+  const std::vector<int>& getPatternCodes(size_t i) const { return codes_[i]; }
+
+  /**
+   * @brief Tell if pairwise distances can be computed for a model.
+   */
+  bool isCompatible(const BranchModelInterface& model) const;
+
+  /**
+   * @return Pattern counts of a bootstrap replicate, that is a multinomial
+   * draw of as many sites as in the alignment.
+   */
+  std::vector<unsigned int> drawBootstrapCounts(std::mt19937& generator) const;
+
+  /**
+   * @return State frequencies, with patterns weighted by the given counts,
+   * estimated as by TransitionModelInterface::setFreqFromData on the
+   * corresponding alignment: unresolved characters are spread over the
+   * states they stand for, gaps are ignored, and pseudoCount is added to
+   * the count of each state.
+   */
+  std::map<int, double> getFrequencies(const std::vector<unsigned int>& counts, double pseudoCount = 0) const;
+
+  /**
+   * @brief Compute all pairwise distances, with patterns weighted by the
+   * given counts.
+   *
+   * The model is used for transition probabilities only; it is not
+   * thread-safe and must not be shared between threads.
+   *
+   * @param singlePrecision If true, distances are stored in single
+   * precision.
+   */
+  std::unique_ptr<TriangularDistanceMatrix> computeMatrix(
+    const TransitionModelInterface& model,
+    const DiscreteDistributionInterface& rateDist,
+    const std::vector<unsigned int>& counts,
+    bool singlePrecision = false) const;
+
+  /**
+   * @brief Compute all pairwise distances of the alignment, rows being
+   * shared between threads.
+   *
+   * @param model     The model, copied by each thread.
+   * @param rateDist  The rate distribution, copied by each thread.
+   * @param nbThreads Number of threads to use.
+   * @param previous  If not null, distances estimated with other parameter
+   * values, from which the search of each distance starts.
+   * @param verbose   If positive, progress is displayed in a gauge.
+   * @param singlePrecision If true, distances are stored in single
+   * precision.
+   */
+  std::unique_ptr<TriangularDistanceMatrix> computeMatrix(
+    const TransitionModelInterface& model,
+    const DiscreteDistributionInterface& rateDist,
+    size_t nbThreads,
+    const TriangularDistanceMatrix* previous = nullptr,
+    size_t verbose = 0,
+    bool singlePrecision = false) const;
+
+private:
+  /**
+   * @brief Compute the distances between sequence i and the next ones.
+   */
+  void computeRow_(
+    size_t i,
+    const TransitionModelInterface& model,
+    const DiscreteDistributionInterface& rateDist,
+    const std::vector<unsigned int>& counts,
+    const TriangularDistanceMatrix* previous,
+    TriangularDistanceMatrix& matrix) const;
+
+public:
+  static const double MIN_DISTANCE;
+  static const double MAX_DISTANCE;
+  static const double TOLERANCE;
+
+  /**
+   * @brief Half-width, in log scale, of the first search interval around
+   * a previous estimate.
+   */
+  static const double WARM_START_RANGE;
+};
+} // end of namespace bpp.
+
+#endif // BPPSUITE_PATTERNDISTANCEESTIMATION_H
@@ -0,0 +1,313 @@
+//
+// File: PatternTreeLikelihood.cpp
+// Created by: Bio++ Development Team
+// Created on: Oct Sun 18 2026
+//
+
+/*
+Copyright or © or Copr. Bio++ Development Team
+
+This software is a computer program whose purpose is to estimate
+phylogenies and evolutionary parameters from a dataset according to
+the maximum likelihood principle.
+
+This software is governed by the CeCILL  license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+*/
+
+
+#include "ParallelTools.h"
+#include "PatternTreeLikelihood.h"
+
+// From the STL:
+#include <cmath>
+#include <algorithm>
+#include <map>
+
+// From bpp-core:
+#include <Bpp/Exceptions.h>
+#include <Bpp/Numeric/NumConstants.h>
+
+using namespace bpp;
+using namespace std;
+
+const size_t PatternTreeLikelihood::CHUNK_SIZE = 256;
+const double PatternTreeLikelihood::SCALING_THRESHOLD = 1e-100;
+
+/******************************************************************************/
+
+PatternTreeLikelihood::PatternTreeLikelihood(
+  const PatternDistanceEstimation& patterns,
+  const Tree& tree,
+  const TransitionModelInterface& model,
+  const DiscreteDistributionInterface& rateDist,
+  size_t nbThreads) :
+  AbstractParametrizable(""),
+  patterns_(&patterns),
+  model_(model.clone()),
+  rateDist_(rateDist.clone()),
+  nbThreads_(nbThreads),
+  firstSons_(),
+  lengths_(),
+  sequences_(),
+  characterLikelihoods_(),
+  minCode_(0),
+  pij_(),
+  classProbabilities_(),
+  logLik_(0.)
+{
+  if (!patterns.isCompatible(model))
+    throw Exception("PatternTreeLikelihood: the model must have one state per character of the alphabet.");
+  size_t n = patterns.getNumberOfSequences();
+  if (tree.getNumberOfLeaves() != n)
+    throw Exception("PatternTreeLikelihood: the tree does not have " + to_string(n) + " leaves.");
+
+  // Nodes in breadth-first order, without recursion so that deep trees are
+  // fine:
+  map<string, size_t> sequenceIndex;
+  for (size_t i = 0; i < n; ++i)
+    sequenceIndex[patterns.getSequenceNames()[i]] = i;
+  vector<int> order(1, tree.getRootId());
+  for (size_t k = 0; k < order.size(); ++k)
+  {
+    firstSons_.push_back(order.size());
+    for (int sonId : tree.getSonsId(order[k]))
+      order.push_back(sonId);
+  }
+  firstSons_.push_back(order.size());
+  lengths_.resize(order.size(), 0.);
+  sequences_.resize(order.size(), n);
+  for (size_t k = 0; k < order.size(); ++k)
+  {
+    int nodeId = order[k];
+    if (k > 0 && tree.hasDistanceToFather(nodeId))
+      lengths_[k] = tree.getDistanceToFather(nodeId);
+    if (firstSons_[k] == firstSons_[k + 1])
+    {
+      auto it = sequenceIndex.find(tree.getNodeName(nodeId));
+      if (it == sequenceIndex.end())
+        throw Exception("PatternTreeLikelihood: unknown leaf '" + tree.getNodeName(nodeId) + "'.");
+      sequences_[k] = it->second;
+    }
+  }
+
+  // Likelihood vectors of the characters found in the patterns; gaps and
+  // fully unknown characters do not carry any information.
+  auto alphabet = patterns.getAlphabet();
+  size_t K = alphabet->getSize();
+  int size = static_cast<int>(K);
+  int maxCode = size - 1;
+  minCode_ = 0;
+  for (size_t i = 0; i < n; ++i)
+  {
+    for (int code : patterns.getPatternCodes(i))
+    {
+      minCode_ = min(minCode_, code);
+      maxCode = max(maxCode, code);
+    }
+  }
+  characterLikelihoods_.resize(static_cast<size_t>(maxCode - minCode_ + 1) * K, 1.);
+  vector<bool> found(static_cast<size_t>(maxCode - minCode_ + 1), false);
+  for (size_t i = 0; i < n; ++i)
+  {
+    for (int code : patterns.getPatternCodes(i))
+    {
+      size_t c = static_cast<size_t>(code - minCode_);
+      if (found[c])
+        continue;
+      found[c] = true;
+      if (alphabet->isGap(code))
+        continue;
+      double* lik = &characterLikelihoods_[c * K];
+      vector<int> states = (code >= 0 && code < size) ? vector<int>(1, code) : alphabet->getAlias(code);
+      std::fill(lik, lik + K, 0.);
+      for (int state : states)
+        lik[static_cast<size_t>(state)] = 1.;
+    }
+  }
+
+  addParameters_(model_->getIndependentParameters());
+  addParameters_(rateDist_->getIndependentParameters());
+  computeLogLikelihood_();
+}
+
+/******************************************************************************/
+
+PatternTreeLikelihood::PatternTreeLikelihood(const PatternTreeLikelihood& lik) :
+  AbstractParametrizable(lik),
+  patterns_(lik.patterns_),
+  model_(lik.model_->clone()),
+  rateDist_(lik.rateDist_->clone()),
+  nbThreads_(lik.nbThreads_),
+  firstSons_(lik.firstSons_),
+  lengths_(lik.lengths_),
+  sequences_(lik.sequences_),
+  characterLikelihoods_(lik.characterLikelihoods_),
+  minCode_(lik.minCode_),
+  pij_(lik.pij_),
+  classProbabilities_(lik.classProbabilities_),
+  logLik_(lik.logLik_)
+{}
+
+PatternTreeLikelihood& PatternTreeLikelihood::operator=(const PatternTreeLikelihood& lik)
+{
+  AbstractParametrizable::operator=(lik);
+  patterns_ = lik.patterns_;
+  model_.reset(lik.model_->clone());
+  rateDist_.reset(lik.rateDist_->clone());
+  nbThreads_ = lik.nbThreads_;
+  firstSons_ = lik.firstSons_;
+  lengths_ = lik.lengths_;
+  sequences_ = lik.sequences_;
+  characterLikelihoods_ = lik.characterLikelihoods_;
+  minCode_ = lik.minCode_;
+  pij_ = lik.pij_;
+  classProbabilities_ = lik.classProbabilities_;
+  logLik_ = lik.logLik_;
+  return *this;
+}
+
+/******************************************************************************/
+
+void PatternTreeLikelihood::fireParameterChanged(const ParameterList& parameters)
+{
+  model_->matchParametersValues(parameters);
+  rateDist_->matchParametersValues(parameters);
+  computeLogLikelihood_();
+}
+
+/******************************************************************************/
+
+void PatternTreeLikelihood::computeLogLikelihood_()
+{
+  // Transition probabilities, computed once in the calling thread since
+  // the model is not thread-safe:
+  size_t K = model_->getNumberOfStates();
+  size_t nbNodes = lengths_.size();
+  size_t nbClasses = rateDist_->getNumberOfCategories();
+  classProbabilities_.resize(nbClasses);
+  pij_.resize(nbNodes * nbClasses * K * K);
+  for (size_t r = 0; r < nbClasses; ++r)
+  {
+    classProbabilities_[r] = rateDist_->getProbability(r);
+    double rate = rateDist_->getCategory(r);
+    for (size_t k = 1; k < nbNodes; ++k)
+    {
+      const Matrix<double>& pij = model_->getPij_t(rate * lengths_[k]);
+      double* p = &pij_[(k * nbClasses + r) * K * K];
+      for (size_t a = 0; a < K; ++a)
+        for (size_t b = 0; b < K; ++b)
+          p[a * K + b] = pij(a, b);
+    }
+  }
+
+  size_t nbPatterns = patterns_->getNumberOfPatterns();
+  size_t nbChunks = (nbPatterns + CHUNK_SIZE - 1) / CHUNK_SIZE;
+  vector<double> chunkLogLiks(nbChunks, 0.);
+  ParallelTools::parallelFor(nbChunks, nbThreads_,
+    [&](size_t c, size_t)
+    {
+      chunkLogLiks[c] = computeLogLikelihood_(c * CHUNK_SIZE, min(nbPatterns, (c + 1) * CHUNK_SIZE));
+    });
+
+  // Summed in chunk order, so that the result does not depend on the
+  // number of threads:
+  logLik_ = 0.;
+  for (double chunkLogLik : chunkLogLiks)
+    logLik_ += chunkLogLik;
+}
+
+/******************************************************************************/
+
+double PatternTreeLikelihood::computeLogLikelihood_(size_t first, size_t last) const
+{
+  size_t K = model_->getNumberOfStates();
+  size_t nbNodes = lengths_.size();
+  size_t nbClasses = classProbabilities_.size();
+  const vector<double>& freqs = model_->getFrequencies();
+  const vector<unsigned int>& counts = patterns_->getPatternCounts();
+
+  vector<double> partials(nbNodes * K);
+  vector<double> logScales(nbNodes, 0.);
+  vector<double> classLogLiks(nbClasses);
+  double logLik = 0.;
+  for (size_t p = first; p < last; ++p)
+  {
+    for (size_t r = 0; r < nbClasses; ++r)
+    {
+      // Felsenstein's pruning, sons before fathers:
+      for (size_t k = nbNodes; k > 0; --k)
+      {
+        size_t node = k - 1;
+        double* partial = &partials[node * K];
+        if (firstSons_[node] == firstSons_[node + 1])
+        {
+          int code = patterns_->getPatternCodes(sequences_[node])[p];
+          const double* lik = &characterLikelihoods_[static_cast<size_t>(code - minCode_) * K];
+          std::copy(lik, lik + K, partial);
+          logScales[node] = 0.;
+          continue;
+        }
+        std::fill(partial, partial + K, 1.);
+        double logScale = 0.;
+        for (size_t son = firstSons_[node]; son < firstSons_[node + 1]; ++son)
+        {
+          const double* pij = &pij_[(son * nbClasses + r) * K * K];
+          const double* sonPartial = &partials[son * K];
+          for (size_t a = 0; a < K; ++a)
+          {
+            double sum = 0.;
+            for (size_t b = 0; b < K; ++b)
+              sum += pij[a * K + b] * sonPartial[b];
+            partial[a] *= sum;
+          }
+          logScale += logScales[son];
+        }
+        double maxPartial = *max_element(partial, partial + K);
+        if (maxPartial > 0. && maxPartial < SCALING_THRESHOLD)
+        {
+          for (size_t a = 0; a < K; ++a)
+            partial[a] /= maxPartial;
+          logScale += log(maxPartial);
+        }
+        logScales[node] = logScale;
+      }
+
+      double lik = 0.;
+      for (size_t a = 0; a < K; ++a)
+        lik += freqs[a] * partials[a];
+      classLogLiks[r] = log(max(lik, NumConstants::VERY_TINY())) + logScales[0];
+    }
+
+    // Mixture over rate classes, in log scale:
+    double maxLogLik = *max_element(classLogLiks.begin(), classLogLiks.end());
+    double sum = 0.;
+    for (size_t r = 0; r < nbClasses; ++r)
+      sum += classProbabilities_[r] * exp(classLogLiks[r] - maxLogLik);
+    logLik += counts[p] * (maxLogLik + log(sum));
+  }
+  return logLik;
+}
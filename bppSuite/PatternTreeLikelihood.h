@@ -0,0 +1,173 @@
+//
+// File: PatternTreeLikelihood.h
+// Created by: Bio++ Development Team
+// Created on: Oct Sun 18 2026
+//
+
+/*
+Copyright or © or Copr. Bio++ Development Team
+
+This software is a computer program whose purpose is to estimate
+phylogenies and evolutionary parameters from a dataset according to
+the maximum likelihood principle.
+
+This software is governed by the CeCILL  license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+*/
+
+
+#ifndef BPPSUITE_PATTERNTREELIKELIHOOD_H
+#define BPPSUITE_PATTERNTREELIKELIHOOD_H
+
+#include "PatternDistanceEstimation.h"
+
+// From the STL:
+#include <memory>
+#include <vector>
+
+// From bpp-core:
+#include <Bpp/Numeric/AbstractParametrizable.h>
+#include <Bpp/Numeric/Function/Functions.h>
+#include <Bpp/Numeric/Prob/DiscreteDistribution.h>
+
+// From bpp-phyl:
+#include <Bpp/Phyl/Model/SubstitutionModel.h>
+#include <Bpp/Phyl/Tree/Tree.h>
+
+namespace bpp
+{
+/**
+ * @brief Opposite of the log-likelihood of an alignment on a fixed tree,
+ * as a function of the model and rate distribution parameters.
+ *
+ * Sites are taken as the distinct patterns of a PatternDistanceEstimation,
+ * weighted by their counts. Transition probabilities are computed once per
+ * evaluation, and the patterns are then shared in chunks between threads,
+ * each of them running Felsenstein's pruning on its chunk. Partial
+ * likelihoods are rescaled when they get too small, so that large trees
+ * do not underflow.
+ *
+ * Branch lengths are those of the tree, and are not parameters of the
+ * function. The root frequencies are the equilibrium frequencies of the
+ * model, which is meant to be reversible.
+ */
+class PatternTreeLikelihood :
+  public virtual FunctionInterface,
+  public AbstractParametrizable
+{
+private:
+  const PatternDistanceEstimation* patterns_;
+  std::unique_ptr<TransitionModelInterface> model_;
+  std::unique_ptr<DiscreteDistributionInterface> rateDist_;
+  size_t nbThreads_;
+
+  /**
+   * @brief Nodes in breadth-first order: the sons of the k-th node are at
+   * positions firstSons_[k] to firstSons_[k + 1] - 1.
+   */
+  std::vector<size_t> firstSons_;
+  std::vector<double> lengths_;
+
+  /**
+   * @brief Index of the sequence of each leaf, in the patterns.
+   */
+  std::vector<size_t> sequences_;
+
+  /**
+   * @brief Likelihood vector of each character code, from minCode_ on.
+   */
+  std::vector<double> characterLikelihoods_;
+  int minCode_;
+
+  /**
+   * @brief Transition probabilities along each branch, rate class by rate
+   * class.
+   */
+  std::vector<double> pij_;
+  std::vector<double> classProbabilities_;
+  double logLik_;
+
+public:
+  /**
+   * @param patterns  The site patterns, which must outlive the function.
+   * @param tree      The tree, with one leaf per sequence.
+   * @param model     The model, copied.
+   * @param rateDist  The rate distribution, copied.
+   * @param nbThreads Number of threads to use for each evaluation.
+   */
+  PatternTreeLikelihood(
+    const PatternDistanceEstimation& patterns,
+    const Tree& tree,
+    const TransitionModelInterface& model,
+    const DiscreteDistributionInterface& rateDist,
+    size_t nbThreads);
+
+  PatternTreeLikelihood(const PatternTreeLikelihood& lik);
+
+  PatternTreeLikelihood& operator=(const PatternTreeLikelihood& lik);
+
+  PatternTreeLikelihood* clone() const override { return new PatternTreeLikelihood(*this); }
+
+public:
+  void setParameters(const ParameterList& parameters) override
+  {
+    matchParametersValues(parameters);
+  }
+
+  double getValue() const override { return -logLik_; }
+
+  double getLogLikelihood() const { return logLik_; }
+
+  const TransitionModelInterface& model() const { return *model_; }
+
+  const DiscreteDistributionInterface& rateDistribution() const { return *rateDist_; }
+
+protected:
+  void fireParameterChanged(const ParameterList& parameters) override;
+
+private:
+  void computeLogLikelihood_();
+
+  /**
+   * @return The log-likelihood of patterns first to last - 1, weighted by
+   * their counts.
+   */
+  double computeLogLikelihood_(size_t first, size_t last) const;
+
+public:
+  /**
+   * @brief Number of patterns handed out at once to a thread.
+   */
+  static const size_t CHUNK_SIZE;
+
+  /**
+   * @brief Partial likelihoods below this value are rescaled.
+   */
+  static const double SCALING_THRESHOLD;
+};
+} // end of namespace bpp.
+
+#endif // BPPSUITE_PATTERNTREELIKELIHOOD_H
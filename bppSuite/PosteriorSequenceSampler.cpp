@@ -0,0 +1,309 @@
+//
+// File: PosteriorSequenceSampler.cpp
+// Created by: Bio++ Development Team
+// Created on: Oct Sun 18 2026
+//
+
+/*
+Copyright or © or Copr. Bio++ Development Team
+
+This software is a computer program whose purpose is to estimate
+phylogenies and evolutionary parameters from a dataset according to
+the maximum likelihood principle.
+
+This software is governed by the CeCILL  license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+*/
+
+#include "PosteriorSequenceSampler.h"
+#include "ParallelTools.h"
+
+// From the STL:
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+// From bpp-core:
+#include <Bpp/Exceptions.h>
+#include <Bpp/Numeric/Random/RandomTools.h>
+#include <Bpp/Text/TextTools.h>
+
+// From bpp-phyl:
+#include <Bpp/Phyl/Model/MixedTransitionModel.h>
+
+using namespace bpp;
+using namespace std;
+
+// Number of consecutive sites sampled with the same generator.
+const size_t POSTERIOR_SAMPLING_CHUNK_SIZE = 1000;
+
+namespace
+{
+/**
+ * @brief Draw an index with probability proportional to its weight.
+ */
+size_t pickWeighted(const double* weights, size_t n, std::mt19937& generator)
+{
+  double sum = 0;
+  for (size_t i = 0; i < n; ++i)
+    sum += weights[i];
+  if (!(sum > 0))
+    throw Exception("PosteriorSequenceSampler: null likelihood, the data are incompatible with the process.");
+  double target = std::uniform_real_distribution<double>(0., sum)(generator);
+  for (size_t i = 0; i < n; ++i)
+  {
+    target -= weights[i];
+    if (target < 0)
+      return i;
+  }
+  // Rounding: return the last outcome with a positive weight.
+  size_t last = n - 1;
+  while (weights[last] <= 0)
+    last--;
+  return last;
+}
+}
+
+/******************************************************************************/
+
+bool PosteriorSequenceSampler::isSupported(const LikelihoodCalculationSingleProcess& calculation)
+{
+  auto process = calculation.getSubstitutionProcess();
+  auto tree = process->getParametrizablePhyloTree();
+  vector<shared_ptr<PhyloNode>> nodes(1, tree->getRoot());
+  for (size_t n = 0; n < nodes.size(); ++n)
+  {
+    for (auto son : tree->getSons(nodes[n]))
+    {
+      auto model = dynamic_pointer_cast<const TransitionModelInterface>(process->getModelForNode(tree->getNodeIndex(son)));
+      if (!model || dynamic_pointer_cast<const MixedTransitionModelInterface>(model))
+        return false;
+      nodes.push_back(son);
+    }
+  }
+  return true;
+}
+
+/******************************************************************************/
+
+PosteriorSequenceSampler::PosteriorSequenceSampler(shared_ptr<LikelihoodCalculationSingleProcess> calculation) :
+  data_(calculation->getData()),
+  alphabet_(data_->getAlphabet()),
+  nbStates_(calculation->stateMap().getNumberOfModelStates()),
+  nbClasses_(0),
+  logClassProbabilities_(),
+  rootFrequencies_(),
+  alphabetStates_(),
+  names_(),
+  sons_(),
+  isLeaf_(),
+  sequences_(),
+  transitions_(),
+  outputInternal_(false)
+{
+  if (!isSupported(*calculation))
+    throw Exception("PosteriorSequenceSampler: only processes with plain transition models are supported.");
+  auto process = calculation->getSubstitutionProcess();
+  auto tree = process->getParametrizablePhyloTree();
+
+  const auto& stateMap = calculation->stateMap();
+  for (size_t s = 0; s < nbStates_; ++s)
+    alphabetStates_.push_back(stateMap.getAlphabetStateAsInt(s));
+
+  nbClasses_ = process->getNumberOfClasses();
+  vector<double> rates;
+  for (size_t c = 0; c < nbClasses_; ++c)
+  {
+    logClassProbabilities_.push_back(log(process->getProbabilityForModel(c)));
+    rates.push_back(process->getRateForModel(c));
+  }
+  rootFrequencies_ = process->getRootFrequencies();
+
+  // Nodes in pre-order:
+  vector<shared_ptr<PhyloNode>> nodes(1, tree->getRoot());
+  for (size_t n = 0; n < nodes.size(); ++n)
+  {
+    auto node = nodes[n];
+    unsigned int index = tree->getNodeIndex(node);
+    names_.push_back(node->hasName() ? node->getName() : TextTools::toString(index));
+    isLeaf_.push_back(tree->isLeaf(node));
+    sequences_.push_back(isLeaf_.back() ? data_->getSequencePosition(node->getName()) : 0);
+    sons_.push_back(vector<size_t>());
+    for (auto son : tree->getSons(node))
+    {
+      sons_.back().push_back(nodes.size());
+      nodes.push_back(son);
+    }
+
+    vector<vector<double>> transitions;
+    if (n > 0)
+    {
+      auto model = dynamic_pointer_cast<const TransitionModelInterface>(process->getModelForNode(index));
+      double length = tree->getEdgeToFather(node)->getLength();
+      for (size_t c = 0; c < nbClasses_; ++c)
+      {
+        const Matrix<double>& pij = model->getPij_t(length * rates[c]);
+        vector<double> matrix(nbStates_ * nbStates_);
+        for (size_t i = 0; i < nbStates_; ++i)
+        {
+          for (size_t j = 0; j < nbStates_; ++j)
+          {
+            matrix[i * nbStates_ + j] = pij(i, j);
+          }
+        }
+        transitions.push_back(matrix);
+      }
+    }
+    transitions_.push_back(transitions);
+  }
+}
+
+/******************************************************************************/
+
+void PosteriorSequenceSampler::simulateSite_(size_t site, std::mt19937& generator, vector<double>& likelihoods, vector<size_t>& states) const
+{
+  size_t nbNodes = names_.size();
+  size_t classSize = nbNodes * nbStates_;
+
+  // Conditional likelihoods of each subtree, scaled to a maximum of 1 per
+  // node, from the leaves up:
+  vector<double> logLikelihoods(nbClasses_);
+  for (size_t c = 0; c < nbClasses_; ++c)
+  {
+    double logScale = 0;
+    for (size_t n = nbNodes; n > 0; --n)
+    {
+      double* lik = &likelihoods[c * classSize + (n - 1) * nbStates_];
+      if (isLeaf_[n - 1])
+      {
+        for (size_t s = 0; s < nbStates_; ++s)
+          lik[s] = data_->getStateValueAt(site, sequences_[n - 1], alphabetStates_[s]);
+      }
+      else
+      {
+        std::fill(lik, lik + nbStates_, 1.);
+        for (size_t son : sons_[n - 1])
+        {
+          const double* sonLik = &likelihoods[c * classSize + son * nbStates_];
+          const vector<double>& pij = transitions_[son][c];
+          for (size_t i = 0; i < nbStates_; ++i)
+          {
+            double x = 0;
+            for (size_t j = 0; j < nbStates_; ++j)
+              x += pij[i * nbStates_ + j] * sonLik[j];
+            lik[i] *= x;
+          }
+        }
+      }
+      double maxLik = *std::max_element(lik, lik + nbStates_);
+      if (maxLik > 0)
+      {
+        for (size_t s = 0; s < nbStates_; ++s)
+          lik[s] /= maxLik;
+        logScale += log(maxLik);
+      }
+    }
+    double rootLik = 0;
+    for (size_t s = 0; s < nbStates_; ++s)
+      rootLik += rootFrequencies_[s] * likelihoods[c * classSize + s];
+    logLikelihoods[c] = rootLik > 0 ? logClassProbabilities_[c] + log(rootLik) + logScale : -numeric_limits<double>::infinity();
+  }
+
+  // Class:
+  double maxLog = *std::max_element(logLikelihoods.begin(), logLikelihoods.end());
+  vector<double> weights(max(nbClasses_, nbStates_));
+  for (size_t c = 0; c < nbClasses_; ++c)
+    weights[c] = exp(logLikelihoods[c] - maxLog);
+  size_t c = pickWeighted(&weights[0], nbClasses_, generator);
+  const double* classLik = &likelihoods[c * classSize];
+
+  // Root state, then the states of the sons given the state of their father:
+  for (size_t s = 0; s < nbStates_; ++s)
+    weights[s] = rootFrequencies_[s] * classLik[s];
+  states[0] = pickWeighted(&weights[0], nbStates_, generator);
+  for (size_t n = 0; n < nbNodes; ++n)
+  {
+    for (size_t son : sons_[n])
+    {
+      const double* pij = &transitions_[son][c][states[n] * nbStates_];
+      const double* sonLik = classLik + son * nbStates_;
+      for (size_t s = 0; s < nbStates_; ++s)
+        weights[s] = pij[s] * sonLik[s];
+      states[son] = pickWeighted(&weights[0], nbStates_, generator);
+    }
+  }
+}
+
+/******************************************************************************/
+
+unique_ptr<VectorSiteContainer> PosteriorSequenceSampler::simulate(size_t nbSites, size_t nbThreads) const
+{
+  if (nbSites > getNumberOfSites())
+    throw Exception("PosteriorSequenceSampler::simulate. Can not simulate more sites (" + TextTools::toString(nbSites) + ") than in the data (" + TextTools::toString(getNumberOfSites()) + ").");
+
+  size_t nbNodes = names_.size();
+  vector<size_t> outputNodes;
+  for (size_t n = 0; n < nbNodes; ++n)
+  {
+    if (isLeaf_[n] || outputInternal_)
+      outputNodes.push_back(n);
+  }
+
+  // Chunks are sampled from seeds picked beforehand, so that the result
+  // does not depend on the number of threads.
+  size_t nbChunks = (nbSites + POSTERIOR_SAMPLING_CHUNK_SIZE - 1) / POSTERIOR_SAMPLING_CHUNK_SIZE;
+  vector<unsigned int> seeds(nbChunks);
+  for (auto& seed : seeds)
+    seed = RandomTools::giveIntRandomNumberBetweenZeroAndEntry<unsigned int>(numeric_limits<unsigned int>::max());
+
+  vector<vector<int>> contents(outputNodes.size(), vector<int>(nbSites));
+  vector<vector<double>> likelihoods(nbThreads, vector<double>(nbClasses_ * nbNodes * nbStates_));
+  vector<vector<size_t>> states(nbThreads, vector<size_t>(nbNodes));
+  ParallelTools::parallelFor(nbChunks, nbThreads,
+    [&](size_t k, size_t w)
+    {
+      std::mt19937 generator(seeds[k]);
+      size_t last = min(nbSites, (k + 1) * POSTERIOR_SAMPLING_CHUNK_SIZE);
+      for (size_t i = k * POSTERIOR_SAMPLING_CHUNK_SIZE; i < last; ++i)
+      {
+        simulateSite_(i, generator, likelihoods[w], states[w]);
+        for (size_t o = 0; o < outputNodes.size(); ++o)
+          contents[o][i] = alphabetStates_[states[w][outputNodes[o]]];
+      }
+    });
+
+  auto sites = make_unique<VectorSiteContainer>(alphabet_);
+  for (size_t o = 0; o < outputNodes.size(); ++o)
+  {
+    const string& name = names_[outputNodes[o]];
+    auto seq = make_unique<Sequence>(name, contents[o], alphabet_);
+    sites->addSequence(name, seq);
+    vector<int>().swap(contents[o]);
+  }
+  return sites;
+}
+
+/******************************************************************************/
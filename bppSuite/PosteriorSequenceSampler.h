@@ -0,0 +1,145 @@
+//
+// File: PosteriorSequenceSampler.h
+// Created by: Bio++ Development Team
+// Created on: Oct Sun 18 2026
+//
+
+/*
+Copyright or © or Copr. Bio++ Development Team
+
+This software is a computer program whose purpose is to estimate
+phylogenies and evolutionary parameters from a dataset according to
+the maximum likelihood principle.
+
+This software is governed by the CeCILL  license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+*/
+
+#ifndef BPPSUITE_POSTERIORSEQUENCESAMPLER_H
+#define BPPSUITE_POSTERIORSEQUENCESAMPLER_H
+
+// From the STL:
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+// From bpp-seq:
+#include <Bpp/Seq/Container/VectorSiteContainer.h>
+
+// From bpp-phyl:
+#include <Bpp/Phyl/Likelihood/DataFlow/LikelihoodCalculationSingleProcess.h>
+
+namespace bpp
+{
+/**
+ * @brief Simulate sequences conditionally on the data of a likelihood
+ * calculation, with sites sampled in parallel.
+ *
+ * At each site, the conditional likelihoods of the subtrees are computed
+ * for every class of the process, then a class, the root state and the
+ * states down the tree are drawn from their posterior distributions, as
+ * in GivenDataSubstitutionProcessSequenceSimulator.
+ *
+ * Transition probabilities are computed once, in the constructor. Sites
+ * are then independent: they are handed out by chunks to the workers, and
+ * each chunk is sampled with its own generator, seeded in the calling
+ * thread. Results do not depend on the number of threads.
+ *
+ * Only processes whose branch models are plain transition models are
+ * supported, see isSupported().
+ */
+class PosteriorSequenceSampler
+{
+private:
+  std::shared_ptr<const AlignmentDataInterface> data_;
+  std::shared_ptr<const Alphabet> alphabet_;
+  size_t nbStates_;
+  size_t nbClasses_;
+  std::vector<double> logClassProbabilities_;
+  std::vector<double> rootFrequencies_;
+
+  /**
+   * @brief Alphabet state of each model state.
+   */
+  std::vector<int> alphabetStates_;
+
+  /**
+   * @brief Nodes in pre-order, the root first.
+   */
+  std::vector<std::string> names_;
+  std::vector<std::vector<size_t>> sons_;
+  std::vector<bool> isLeaf_;
+
+  /**
+   * @brief Position of leaf sequences in the data.
+   */
+  std::vector<size_t> sequences_;
+
+  /**
+   * @brief Transition probabilities of the branch above each node, per
+   * class, as nbStates_ x nbStates_ row-major matrices.
+   */
+  std::vector<std::vector<std::vector<double>>> transitions_;
+
+  bool outputInternal_;
+
+public:
+  /**
+   * @throw Exception if the process is not supported.
+   */
+  PosteriorSequenceSampler(std::shared_ptr<LikelihoodCalculationSingleProcess> calculation);
+
+public:
+  /**
+   * @return Whether all the branch models of the process of a likelihood
+   * calculation are plain (not mixed) transition models.
+   */
+  static bool isSupported(const LikelihoodCalculationSingleProcess& calculation);
+
+  size_t getNumberOfSites() const { return data_->getNumberOfSites(); }
+
+  void outputInternalSequences(bool yn) { outputInternal_ = yn; }
+
+  /**
+   * @brief Simulate the first nbSites sites of the data.
+   *
+   * @throw Exception if nbSites is larger than the number of sites of the data.
+   */
+  std::unique_ptr<VectorSiteContainer> simulate(size_t nbSites, size_t nbThreads) const;
+
+private:
+  /**
+   * @brief Sample the states of all nodes at a site.
+   *
+   * @param likelihoods Work space of nbClasses_ x nodes x nbStates_ values.
+   * @param states      The sampled model state of each node.
+   */
+  void simulateSite_(size_t site, std::mt19937& generator, std::vector<double>& likelihoods, std::vector<size_t>& states) const;
+};
+} // end of namespace bpp.
+
+#endif // BPPSUITE_POSTERIORSEQUENCESAMPLER_H
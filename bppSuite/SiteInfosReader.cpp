@@ -0,0 +1,191 @@
+//
+// File: SiteInfosReader.cpp
+// Created by: Bio++ Development Team
+// Created on: Oct Sun 18 2026
+//
+
+/*
+Copyright or © or Copr. Bio++ Development Team
+
+This software is a computer program whose purpose is to simulate sequence
+data according to a phylogenetic tree and an evolutionary model.
+
+This software is governed by the CeCILL  license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+*/
+
+#include "SiteInfosReader.h"
+
+// From the STL:
+#include <fstream>
+#include <algorithm>
+#include <cstdlib>
+
+// From bpp-core:
+#include <Bpp/Exceptions.h>
+#include <Bpp/Text/TextTools.h>
+
+using namespace bpp;
+using namespace std;
+
+SiteInfosReader::SiteInfosReader(const string& path, char sep) :
+  path_(path),
+  sep_(sep),
+  columnNames_()
+{
+  ifstream in(path_.c_str(), ios::in);
+  if (!in)
+    throw IOException("SiteInfosReader: can't open file " + path_);
+  string line;
+  if (!getline(in, line))
+    throw IOException("SiteInfosReader: empty file " + path_);
+  if (!line.empty() && line.back() == '\r')
+    line.pop_back();
+  size_t start = 0;
+  for (size_t pos = line.find(sep_); pos != string::npos; pos = line.find(sep_, start))
+  {
+    columnNames_.push_back(line.substr(start, pos - start));
+    start = pos + 1;
+  }
+  columnNames_.push_back(line.substr(start));
+}
+
+size_t SiteInfosReader::getColumnIndex_(const string& name) const
+{
+  auto it = find(columnNames_.begin(), columnNames_.end(), name);
+  if (it == columnNames_.end())
+    throw Exception("SiteInfosReader: no column '" + name + "' in file " + path_);
+  return static_cast<size_t>(it - columnNames_.begin());
+}
+
+size_t SiteInfosReader::getNumberOfRows() const
+{
+  ifstream in(path_.c_str(), ios::in);
+  string line;
+  getline(in, line);
+  size_t nbRows = 0;
+  while (getline(in, line))
+  {
+    if (!TextTools::isEmpty(line))
+      nbRows++;
+  }
+  return nbRows;
+}
+
+void SiteInfosReader::read(
+  const vector<size_t>& rows,
+  const string& rateCol,
+  const string& stateCol,
+  const Alphabet& alphabet,
+  vector<double>& rates,
+  vector<int>& states) const
+{
+  bool withRates = rateCol != "none";
+  bool withStates = stateCol != "none";
+  size_t rateIndex = withRates ? getColumnIndex_(rateCol) : 0;
+  size_t stateIndex = withStates ? getColumnIndex_(stateCol) : 0;
+  size_t lastIndex = max(withRates ? rateIndex : 0, withStates ? stateIndex : 0);
+
+  // Distinct rows to read, in file order:
+  bool allRows = rows.empty();
+  vector<size_t> wanted(rows);
+  sort(wanted.begin(), wanted.end());
+  wanted.erase(unique(wanted.begin(), wanted.end()), wanted.end());
+
+  vector<double> wantedRates;
+  vector<int> wantedStates;
+
+  ifstream in(path_.c_str(), ios::in);
+  if (!in)
+    throw IOException("SiteInfosReader::read: can't open file " + path_);
+  string line;
+  getline(in, line);
+
+  vector<size_t> fieldStart(lastIndex + 2);
+  size_t row = 0;
+  size_t next = 0;
+  while ((allRows || next < wanted.size()) && getline(in, line))
+  {
+    if (TextTools::isEmpty(line))
+      continue;
+    if (!allRows && wanted[next] != row)
+    {
+      row++;
+      continue;
+    }
+
+    // Only the fields up to the last requested column are located:
+    if (!line.empty() && line.back() == '\r')
+      line.pop_back();
+    fieldStart[0] = 0;
+    size_t nbFields = 1;
+    for (size_t pos = 0; nbFields <= lastIndex + 1 && pos < line.size(); ++pos)
+    {
+      if (line[pos] == sep_)
+        fieldStart[nbFields++] = pos + 1;
+    }
+    if (nbFields <= lastIndex)
+      throw IOException("SiteInfosReader::read: missing columns at row " + TextTools::toString(row) + " of file " + path_);
+    if (nbFields == lastIndex + 1)
+      fieldStart[nbFields] = line.size() + 1;
+
+    if (withRates)
+    {
+      const char* field = line.c_str() + fieldStart[rateIndex];
+      char* end;
+      double rate = strtod(field, &end);
+      if (end == field)
+        throw Exception("SiteInfosReader::read: incorrect rate '" + line.substr(fieldStart[rateIndex], fieldStart[rateIndex + 1] - fieldStart[rateIndex] - 1) + "' at row " + TextTools::toString(row) + " of file " + path_);
+      wantedRates.push_back(rate);
+    }
+    if (withStates)
+      wantedStates.push_back(alphabet.charToInt(line.substr(fieldStart[stateIndex], fieldStart[stateIndex + 1] - fieldStart[stateIndex] - 1)));
+
+    row++;
+    next++;
+  }
+  if (!allRows && next < wanted.size())
+    throw Exception("SiteInfosReader::read: row " + TextTools::toString(wanted[next]) + " not found in file " + path_);
+
+  if (allRows)
+  {
+    rates.swap(wantedRates);
+    states.swap(wantedStates);
+    return;
+  }
+
+  // Back to the requested order:
+  rates.resize(withRates ? rows.size() : 0);
+  states.resize(withStates ? rows.size() : 0);
+  for (size_t i = 0; i < rows.size(); ++i)
+  {
+    size_t k = static_cast<size_t>(lower_bound(wanted.begin(), wanted.end(), rows[i]) - wanted.begin());
+    if (withRates)
+      rates[i] = wantedRates[k];
+    if (withStates)
+      states[i] = wantedStates[k];
+  }
+}
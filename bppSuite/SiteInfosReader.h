@@ -0,0 +1,107 @@
+//
+// File: SiteInfosReader.h
+// Created by: Bio++ Development Team
+// Created on: Oct Sun 18 2026
+//
+
+/*
+Copyright or © or Copr. Bio++ Development Team
+
+This software is a computer program whose purpose is to simulate sequence
+data according to a phylogenetic tree and an evolutionary model.
+
+This software is governed by the CeCILL  license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+*/
+
+#ifndef BPPSUITE_SITEINFOSREADER_H
+#define BPPSUITE_SITEINFOSREADER_H
+
+// From the STL:
+#include <string>
+#include <vector>
+
+// From bpp-seq:
+#include <Bpp/Seq/Alphabet/Alphabet.h>
+
+namespace bpp
+{
+/**
+ * @brief Streaming reader for site information tables, like the ones
+ * output by bppML.
+ *
+ * The table is read line by line, and only the requested columns of the
+ * requested rows are converted, directly to numbers or alphabet states,
+ * so that the whole table is never stored in memory.
+ */
+class SiteInfosReader
+{
+private:
+  std::string path_;
+  char sep_;
+  std::vector<std::string> columnNames_;
+
+public:
+  /**
+   * @param path Path of the table, with column names on the first line.
+   * @param sep  Column separator.
+   */
+  SiteInfosReader(const std::string& path, char sep = '\t');
+
+public:
+  const std::vector<std::string>& getColumnNames() const { return columnNames_; }
+
+  /**
+   * @return The number of rows of the table, not counting the header.
+   */
+  size_t getNumberOfRows() const;
+
+  /**
+   * @brief Read a rate and/or a state column.
+   *
+   * @param rows     Rows to read, in any order and possibly repeated. All
+   *                 rows are read if empty.
+   * @param rateCol  Name of the rate column, or "none".
+   * @param stateCol Name of the state column, or "none".
+   * @param alphabet Alphabet used to decode the states.
+   * @param rates    Rates of the rows, in the order of rows.
+   * @param states   Character codes of the rows, in the order of rows.
+   * @throw Exception if a column or a row is not found.
+   */
+  void read(
+    const std::vector<size_t>& rows,
+    const std::string& rateCol,
+    const std::string& stateCol,
+    const Alphabet& alphabet,
+    std::vector<double>& rates,
+    std::vector<int>& states) const;
+
+private:
+  size_t getColumnIndex_(const std::string& name) const;
+};
+} // end of namespace bpp.
+
+#endif // BPPSUITE_SITEINFOSREADER_H
@@ -0,0 +1,280 @@
+//
+// File: TriangularDistanceMatrix.cpp
+// Created by: Bio++ Development Team
+// Created on: Oct Sun 18 2026
+//
+
+/*
+Copyright or © or Copr. Bio++ Development Team
+
+This software is a computer program whose purpose is to estimate
+phylogenies and evolutionary parameters from a dataset according to
+the maximum likelihood principle.
+
+This software is governed by the CeCILL  license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+*/
+
+#include "TriangularDistanceMatrix.h"
+
+// From the STL:
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// From bpp-core:
+#include <Bpp/Exceptions.h>
+
+using namespace bpp;
+using namespace std;
+
+const string TriangularDistanceMatrix::FORMAT_NAME = "Binary";
+
+namespace
+{
+const char MAGIC[] = "BPPDMAT";
+const char VERSION = 1;
+
+bool isLittleEndian()
+{
+  uint16_t one = 1;
+  unsigned char first;
+  memcpy(&first, &one, 1);
+  return first == 1;
+}
+
+void writeUInt(ostream& out, uint64_t x, size_t nbBytes)
+{
+  for (size_t i = 0; i < nbBytes; ++i)
+    out.put(static_cast<char>((x >> (8 * i)) & 0xFF));
+}
+
+uint64_t readUInt(istream& in, size_t nbBytes)
+{
+  uint64_t x = 0;
+  for (size_t i = 0; i < nbBytes; ++i)
+  {
+    int c = in.get();
+    if (c == EOF)
+      throw IOException("TriangularDistanceMatrix: unexpected end of file.");
+    x |= static_cast<uint64_t>(c & 0xFF) << (8 * i);
+  }
+  return x;
+}
+}
+
+/******************************************************************************/
+
+TriangularDistanceMatrix::TriangularDistanceMatrix() :
+  names_(), data_(), doubleData_(), values_(nullptr), mapping_(nullptr), mappingLength_(0)
+{}
+
+TriangularDistanceMatrix::TriangularDistanceMatrix(const vector<string>& names, bool singlePrecision) :
+  names_(names), data_(), doubleData_(), values_(nullptr), mapping_(nullptr), mappingLength_(0)
+{
+  if (singlePrecision)
+  {
+    data_.assign(getNumberOfValues_(), 0.f);
+    values_ = data_.data();
+  }
+  else
+    doubleData_.assign(getNumberOfValues_(), 0.);
+}
+
+TriangularDistanceMatrix::TriangularDistanceMatrix(const DistanceMatrix& matrix, bool singlePrecision) :
+  TriangularDistanceMatrix(matrix.getNames(), singlePrecision)
+{
+  for (size_t i = 1; i < size(); ++i)
+    for (size_t j = 0; j < i; ++j)
+      set(i, j, matrix(i, j));
+}
+
+TriangularDistanceMatrix::~TriangularDistanceMatrix()
+{
+#ifndef _WIN32
+  if (mapping_)
+    munmap(mapping_, mappingLength_);
+#endif
+}
+
+/******************************************************************************/
+
+void TriangularDistanceMatrix::set(size_t i, size_t j, double distance)
+{
+  if (mapping_)
+    throw Exception("TriangularDistanceMatrix::set: the matrix is read-only.");
+  if (i == j)
+    return;
+  size_t k = i > j ? index_(i, j) : index_(j, i);
+  if (values_)
+    data_[k] = static_cast<float>(distance);
+  else
+    doubleData_[k] = distance;
+}
+
+/******************************************************************************/
+
+unique_ptr<DistanceMatrix> TriangularDistanceMatrix::toDistanceMatrix() const
+{
+  auto matrix = make_unique<DistanceMatrix>(names_);
+  for (size_t i = 0; i < size(); ++i)
+  {
+    (*matrix)(i, i) = 0.;
+    for (size_t j = 0; j < i; ++j)
+    {
+      double d = (*this)(i, j);
+      (*matrix)(i, j) = d;
+      (*matrix)(j, i) = d;
+    }
+  }
+  return matrix;
+}
+
+/******************************************************************************/
+
+void TriangularDistanceMatrix::write(const string& path) const
+{
+  ofstream output(path.c_str(), ios::out | ios::binary);
+  if (!output)
+    throw IOException("TriangularDistanceMatrix::write: can't open file " + path + ".");
+  output.write(MAGIC, 7);
+  output.put(VERSION);
+  writeUInt(output, size(), 8);
+  uint64_t offset = 16;
+  for (const auto& name : names_)
+  {
+    writeUInt(output, name.size(), 4);
+    output.write(name.data(), static_cast<streamsize>(name.size()));
+    offset += 4 + name.size();
+  }
+  for (; offset % 8 != 0; ++offset)
+    output.put(0);
+
+  size_t nbValues = getNumberOfValues_();
+  if (values_ && isLittleEndian())
+    output.write(reinterpret_cast<const char*>(values_), static_cast<streamsize>(nbValues * sizeof(float)));
+  else if (isLittleEndian())
+  {
+    // Double precision distances are converted by blocks:
+    vector<float> buffer(min(nbValues, static_cast<size_t>(1) << 16));
+    for (size_t start = 0; start < nbValues; start += buffer.size())
+    {
+      size_t count = min(buffer.size(), nbValues - start);
+      for (size_t k = 0; k < count; ++k)
+        buffer[k] = static_cast<float>(doubleData_[start + k]);
+      output.write(reinterpret_cast<const char*>(buffer.data()), static_cast<streamsize>(count * sizeof(float)));
+    }
+  }
+  else
+  {
+    for (size_t k = 0; k < nbValues; ++k)
+    {
+      float value = values_ ? values_[k] : static_cast<float>(doubleData_[k]);
+      uint32_t bits;
+      memcpy(&bits, &value, 4);
+      writeUInt(output, bits, 4);
+    }
+  }
+  if (!output)
+    throw IOException("TriangularDistanceMatrix::write: error while writing " + path + ".");
+}
+
+/******************************************************************************/
+
+unique_ptr<TriangularDistanceMatrix> TriangularDistanceMatrix::read(const string& path)
+{
+  ifstream input(path.c_str(), ios::in | ios::binary);
+  if (!input)
+    throw IOException("TriangularDistanceMatrix::read: can't open file " + path + ".");
+  char magic[8];
+  input.read(magic, 8);
+  if (!input || memcmp(magic, MAGIC, 7) != 0)
+    throw IOException("TriangularDistanceMatrix::read: not a binary distance matrix: " + path + ".");
+  if (magic[7] != VERSION)
+    throw IOException("TriangularDistanceMatrix::read: unsupported format version.");
+
+  unique_ptr<TriangularDistanceMatrix> matrix(new TriangularDistanceMatrix());
+  size_t n = static_cast<size_t>(readUInt(input, 8));
+  matrix->names_.resize(n);
+  uint64_t offset = 16;
+  for (auto& name : matrix->names_)
+  {
+    name.resize(static_cast<size_t>(readUInt(input, 4)));
+    input.read(&name[0], static_cast<streamsize>(name.size()));
+    offset += 4 + name.size();
+  }
+  if (!input)
+    throw IOException("TriangularDistanceMatrix::read: unexpected end of file.");
+  offset += (8 - offset % 8) % 8;
+  size_t nbValues = matrix->getNumberOfValues_();
+  size_t length = static_cast<size_t>(offset) + nbValues * sizeof(float);
+
+#ifndef _WIN32
+  if (isLittleEndian() && nbValues > 0)
+  {
+    int fd = open(path.c_str(), O_RDONLY);
+    struct stat status;
+    if (fd >= 0 && fstat(fd, &status) == 0)
+    {
+      if (static_cast<size_t>(status.st_size) < length)
+      {
+        close(fd);
+        throw IOException("TriangularDistanceMatrix::read: unexpected end of file.");
+      }
+      void* mapping = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+      close(fd);
+      if (mapping != MAP_FAILED)
+      {
+        matrix->mapping_ = mapping;
+        matrix->mappingLength_ = length;
+        matrix->values_ = reinterpret_cast<const float*>(static_cast<const char*>(mapping) + offset);
+        return matrix;
+      }
+    }
+    else if (fd >= 0)
+      close(fd);
+  }
+#endif
+
+  // No mapping, read the values:
+  input.seekg(static_cast<streamoff>(offset));
+  matrix->data_.resize(nbValues);
+  for (size_t k = 0; k < nbValues; ++k)
+  {
+    uint32_t bits = static_cast<uint32_t>(readUInt(input, 4));
+    memcpy(&matrix->data_[k], &bits, 4);
+  }
+  matrix->values_ = matrix->data_.data();
+  return matrix;
+}
@@ -0,0 +1,151 @@
+//
+// File: TriangularDistanceMatrix.h
+// Created by: Bio++ Development Team
+// Created on: Oct Sun 18 2026
+//
+
+/*
+Copyright or © or Copr. Bio++ Development Team
+
+This software is a computer program whose purpose is to estimate
+phylogenies and evolutionary parameters from a dataset according to
+the maximum likelihood principle.
+
+This software is governed by the CeCILL  license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+*/
+
+#ifndef BPPSUITE_TRIANGULARDISTANCEMATRIX_H
+#define BPPSUITE_TRIANGULARDISTANCEMATRIX_H
+
+// From the STL:
+#include <memory>
+#include <string>
+#include <vector>
+
+// From bpp-seq:
+#include <Bpp/Seq/DistanceMatrix.h>
+
+namespace bpp
+{
+/**
+ * @brief Symmetric distance matrix storing its lower triangle only, in
+ * double or single precision.
+ *
+ * This takes half of the memory of a DistanceMatrix in double precision,
+ * and a quarter in single precision: about 5 GB for 50,000 sequences
+ * instead of 20 GB.
+ *
+ * The matrix can be saved in a binary format and read back with no
+ * parsing at all: on little-endian platforms supporting it, the file is
+ * memory-mapped, and distances are read directly from the mapping.
+ *
+ * Layout (integers and floats are little-endian):
+ * - "BPPDMAT" followed by the format version byte (1);
+ * - uint64 number of sequences;
+ * - for each sequence, its name, as a uint32 length followed by the
+ *   characters;
+ * - zero padding up to a multiple of 8 bytes from the start of the file;
+ * - float32 distances of the lower triangle, row by row: (1,0), (2,0),
+ *   (2,1), (3,0)...
+ */
+class TriangularDistanceMatrix
+{
+public:
+  static const std::string FORMAT_NAME;
+
+private:
+  std::vector<std::string> names_;
+  std::vector<float> data_;
+  std::vector<double> doubleData_;
+
+  /**
+   * @brief The single precision distances, either in data_ or in the file
+   * mapping, or null if distances are in doubleData_.
+   */
+  const float* values_;
+  void* mapping_;
+  size_t mappingLength_;
+
+public:
+  TriangularDistanceMatrix(const std::vector<std::string>& names, bool singlePrecision = false);
+
+  TriangularDistanceMatrix(const DistanceMatrix& matrix, bool singlePrecision = false);
+
+  TriangularDistanceMatrix(const TriangularDistanceMatrix&) = delete;
+  TriangularDistanceMatrix& operator=(const TriangularDistanceMatrix&) = delete;
+
+  virtual ~TriangularDistanceMatrix();
+
+public:
+  size_t size() const { return names_.size(); }
+
+  const std::vector<std::string>& getNames() const { return names_; }
+
+  bool isSinglePrecision() const { return values_ != nullptr; }
+
+  double operator()(size_t i, size_t j) const
+  {
+    if (i == j)
+      return 0.;
+    size_t k = i > j ? index_(i, j) : index_(j, i);
+    return values_ ? static_cast<double>(values_[k]) : doubleData_[k];
+  }
+
+  /**
+   * @brief Set the distance between i and j. Distinct pairs can be set
+   * from different threads.
+   *
+   * @throw Exception if the matrix was read from a mapped file.
+   */
+  void set(size_t i, size_t j, double distance);
+
+  std::unique_ptr<DistanceMatrix> toDistanceMatrix() const;
+
+  /**
+   * @brief Write the matrix in the binary format, which is always in
+   * single precision.
+   */
+  void write(const std::string& path) const;
+
+  /**
+   * @brief Read a matrix in the binary format, mapping the file to memory
+   * when possible.
+   *
+   * A mapped matrix is read-only.
+   */
+  static std::unique_ptr<TriangularDistanceMatrix> read(const std::string& path);
+
+private:
+  TriangularDistanceMatrix();
+
+  static size_t index_(size_t i, size_t j) { return i * (i - 1) / 2 + j; }
+
+  size_t getNumberOfValues_() const { return size() < 2 ? 0 : size() * (size() - 1) / 2; }
+};
+} // end of namespace bpp.
+
+#endif // BPPSUITE_TRIANGULARDISTANCEMATRIX_H
@@ -39,6 +39,7 @@ knowledge of the CeCILL license and that you accept its terms.
 */
 
 // From the STL:
+#include <fstream>
 #include <iostream>
 #include <iomanip>
 
@@ -58,6 +59,10 @@ using namespace std;
 #include <Bpp/Phyl/Io/Newick.h>
 #include <Bpp/Phyl/App/PhylogeneticsApplicationTools.h>
 
+#include "BipartitionCounter.h"
+#include "NewickTreeReader.h"
+#include "ParallelTools.h"
+
 using namespace bpp;
 
 void help()
@@ -90,7 +95,83 @@ int main(int args, char ** argv)
   BppApplication bppconsense(args, argv, "BppConsense");
   bppconsense.startTimer();
 
-  auto list = PhylogeneticsApplicationTools::getTrees(bppconsense.getParams());
+  // Each tree is converted once to its bipartitions, which are counted
+  // over a common index of the taxa. In streaming mode, trees are read one
+  // at a time from a Newick file and are never all in memory.
+  bool streaming = ApplicationTools::getBooleanParameter("input.trees.streaming", bppconsense.getParams(), false, "", true, 1);
+  size_t nbThreads = ParallelTools::getNumberOfThreads(bppconsense.getParams());
+
+  // Trees are parsed and counted by the workers, each with its own
+  // counter, and counters are merged at the end.
+  vector<unique_ptr<BipartitionCounter>> counters;
+  auto createCounters = [&](const vector<string>& taxa) {
+      for (size_t w = 0; w < nbThreads; ++w)
+        counters.push_back(unique_ptr<BipartitionCounter>(new BipartitionCounter(taxa)));
+    };
+  if (streaming)
+  {
+    string treesPath = ApplicationTools::getAFilePath("input.trees.file", bppconsense.getParams(), true, true, "", false);
+    ApplicationTools::displayResult("Input trees file", treesPath);
+    size_t burnin = ApplicationTools::getParameter<size_t>("input.trees.burnin", bppconsense.getParams(), 0, "", true, 1);
+    ApplicationTools::displayResult("Number of trees discarded (burn-in)", burnin);
+    size_t thinning = ApplicationTools::getParameter<size_t>("input.trees.thinning", bppconsense.getParams(), 1, "", true, 1);
+    if (thinning == 0)
+      throw Exception("input.trees.thinning must be at least 1.");
+    ApplicationTools::displayResult("Thinning", thinning);
+
+    // Descriptions are read by batches, in the main thread:
+    ApplicationTools::displayTask("Counting bipartitions", true);
+    NewickTreeReader reader(treesPath);
+    vector<NewickTreeReader::Description> batch(1000 * nbThreads);
+    size_t nbUsed = 0;
+    bool hasMore = true;
+    while (hasMore)
+    {
+      size_t nbInBatch = 0;
+      while (nbInBatch < batch.size() && (hasMore = reader.nextDescription(batch[nbInBatch])))
+      {
+        size_t index = reader.getNumberOfTreesRead() - 1;
+        if (index >= burnin && (index - burnin) % thinning == 0)
+          nbInBatch++;
+      }
+      if (nbInBatch > 0 && counters.empty())
+        createCounters(NewickTreeReader::parse(batch[0])->getLeavesNames());
+      ParallelTools::parallelFor(nbInBatch, nbThreads,
+        [&](size_t i, size_t w)
+        {
+          counters[w]->addTree(*NewickTreeReader::parse(batch[i]));
+        },
+        [&](size_t)
+        {
+          if (++nbUsed % 1000 == 0)
+            ApplicationTools::displayUnlimitedGauge(nbUsed / 1000);
+        });
+    }
+    ApplicationTools::displayTaskDone();
+    ApplicationTools::displayResult("Number of trees read", reader.getNumberOfTreesRead());
+    if (counters.empty())
+      throw Exception("No tree left after burn-in and thinning.");
+  }
+  else
+  {
+    auto list = PhylogeneticsApplicationTools::getTrees(bppconsense.getParams());
+    if (list.empty())
+      throw Exception("No input tree.");
+    ApplicationTools::displayTask("Counting bipartitions");
+    createCounters(list[0]->getLeavesNames());
+    ParallelTools::parallelFor(list.size(), nbThreads,
+      [&](size_t i, size_t w)
+      {
+        counters[w]->addTree(*list[i]);
+      });
+    ApplicationTools::displayTaskDone();
+  }
+  unique_ptr<BipartitionCounter> bipartitions = std::move(counters[0]);
+  for (size_t w = 1; w < counters.size(); ++w)
+    bipartitions->merge(*counters[w]);
+  counters.clear();
+  ApplicationTools::displayResult("Number of trees used", bipartitions->getNumberOfTrees());
+  ApplicationTools::displayResult("Number of distinct bipartitions", bipartitions->getNumberOfSplits());
 
   unique_ptr<Tree> tree = nullptr;
   string treeMethod = ApplicationTools::getStringParameter("tree", bppconsense.getParams(), "Consensus", "", false, 1);
@@ -102,12 +183,20 @@ int main(int args, char ** argv)
     tree = PhylogeneticsApplicationTools::getTree(bppconsense.getParams());
     ApplicationTools::displayResult("Number of leaves", tree->getNumberOfLeaves());
   }
-  else if(cmdName == "Consensus")
+  else if(cmdName == "Consensus" || cmdName == "MajorityExtended")
   {
-    double threshold = ApplicationTools::getDoubleParameter("threshold", cmdArgs, 0, "", false, 1);
-    ApplicationTools::displayResult("Consensus threshold", TextTools::toString(threshold));
+    // The extended majority rule consensus adds the most frequent compatible
+    // bipartitions to the majority rule ones, which is a threshold of 0.
+    double threshold = 0;
+    if (cmdName == "Consensus")
+    {
+      threshold = ApplicationTools::getDoubleParameter("threshold", cmdArgs, 0, "", false, 1);
+      ApplicationTools::displayResult("Consensus threshold", TextTools::toString(threshold));
+    }
+    bool withLengths = ApplicationTools::getBooleanParameter("branch_lengths", cmdArgs, false, "", true, 1);
+    ApplicationTools::displayBooleanResult("Mean branch lengths", withLengths);
     ApplicationTools::displayTask("Computing consensus tree");
-    tree = TreeTools::thresholdConsensus(list, threshold, true);
+    tree = bipartitions->getConsensusTree(threshold, withLengths);
     ApplicationTools::displayTaskDone();
   }
   else throw Exception("Unknown input tree method: " + treeMethod);
@@ -115,12 +204,44 @@ int main(int args, char ** argv)
   ApplicationTools::displayTask("Compute bootstrap values");
 
   int bsformat = ApplicationTools::getIntParameter("bootstrap.format", bppconsense.getParams(), 0, "", false, 1);
-  TreeTools::computeBootstrapValues(*tree, list, true, bsformat);
+  bipartitions->computeBootstrapValues(*tree, bsformat);
   ApplicationTools::displayTaskDone();
 
   //Write resulting tree:
   PhylogeneticsApplicationTools::writeTree(*tree, bppconsense.getParams());
 
+  //Write the statistics of the branches of the tree:
+  string splitsPath = ApplicationTools::getAFilePath("output.splits.file", bppconsense.getParams(), false, false, "", true, "none", 1);
+  if (splitsPath != "none")
+  {
+    ApplicationTools::displayResult("Branch statistics stored in file", splitsPath);
+    ofstream out(splitsPath.c_str(), ios::out);
+    out << "Taxa\tTrees\tMean.length\tVariance.length" << endl;
+    const vector<string>& taxa = bipartitions->getTaxa();
+    auto writeLengths = [&out](const BipartitionCounter::LengthStatistics& lengths) {
+        if (lengths.number == 0)
+          out << "NA\tNA" << endl;
+        else
+          out << lengths.mean << "\t" << lengths.getVariance() << endl;
+      };
+    for (size_t t = 0; t < taxa.size(); ++t)
+    {
+      out << taxa[t] << "\t" << bipartitions->getNumberOfTrees() << "\t";
+      writeLengths(bipartitions->getLeafBranchLengths(t));
+    }
+    for (const auto& split : bipartitions->getSplits(*tree))
+    {
+      string names;
+      for (size_t t = 0; t < taxa.size(); ++t)
+      {
+        if (split.second[t / 64] & (uint64_t(1) << (t % 64)))
+          names += (names.empty() ? "" : ",") + taxa[t];
+      }
+      out << names << "\t" << bipartitions->getCount(split.second) << "\t";
+      writeLengths(bipartitions->getBranchLengths(split.second));
+    }
+  }
+
   bppconsense.done();
 
   }
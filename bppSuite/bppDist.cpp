@@ -40,14 +40,18 @@
 */
 
 // From the STL:
+#include <algorithm>
 #include <iostream>
 #include <iomanip>
+#include <random>
+#include <limits>
 
 using namespace std;
 
 // From bpp-core:
 #include <Bpp/Version.h>
 #include <Bpp/Numeric/Prob/DiscreteDistribution.h>
+#include <Bpp/Numeric/Function/SimpleMultiDimensions.h>
 #include <Bpp/Io/FileTools.h>
 #include <Bpp/Text/TextTools.h>
 
@@ -73,8 +77,36 @@ using namespace std;
 #include <Bpp/Phyl/OptimizationTools.h>
 #include <Bpp/Phyl/Model/RateDistribution/ConstantRateDistribution.h>
 
+#include "BipartitionCounter.h"
+#include "BitParallelDistanceEstimation.h"
+#include "NeighborJoiningHeuristics.h"
+#include "PackedAlignment.h"
+#include "ParallelDistanceEstimation.h"
+#include "ParallelTools.h"
+#include "PatternDistanceEstimation.h"
+#include "PatternTreeLikelihood.h"
+#include "TriangularDistanceMatrix.h"
+
 using namespace bpp;
 
+namespace
+{
+/**
+ * @brief Give a distance matrix to a tree building method.
+ *
+ * The methods of bpp-phyl need a square matrix of doubles; the neighbor
+ * joining heuristics read the triangular matrix directly.
+ */
+void setDistanceMatrix(AgglomerativeDistanceMethodInterface& distMethod, shared_ptr<const TriangularDistanceMatrix> matrix)
+{
+  auto incremental = dynamic_cast<IncrementalNeighborJoining*>(&distMethod);
+  if (incremental)
+    incremental->setDistanceMatrix(matrix);
+  else
+    distMethod.setDistanceMatrix(*matrix->toDistanceMatrix());
+}
+}
+
 void help()
 {
   (*ApplicationTools::message << "__________________________________________________________________________").endLine();
@@ -113,7 +145,7 @@ int main(int args, char ** argv)
 
     //sites
     
-    auto allSites = SequenceApplicationTools::getSiteContainer(alphabet, bppdist.getParams());
+    auto allSites = PackedAlignment::getSiteContainer(alphabet, bppdist.getParams());
   
     shared_ptr<VectorSiteContainer> sites = SequenceApplicationTools::getSitesToAnalyse(* allSites, bppdist.getParams());
     
@@ -165,6 +197,18 @@ int main(int args, char ** argv)
       bionj->outputPositiveLengths(true);
       distMethod = std::move(bionj);
     }
+    else if(method == "rapidnj")
+    {
+      auto rapidnj = make_unique<RapidNeighborJoining>();
+      rapidnj->outputPositiveLengths(true);
+      distMethod = std::move(rapidnj);
+    }
+    else if(method == "fastnj")
+    {
+      auto fastnj = make_unique<FastNeighborJoining>();
+      fastnj->outputPositiveLengths(true);
+      distMethod = std::move(fastnj);
+    }
     else throw Exception("Unknown tree reconstruction method.");
   
     string type = ApplicationTools::getStringParameter("optimization.method", bppdist.getParams(), "init");
@@ -229,42 +273,160 @@ int main(int args, char ** argv)
     double tolerance = ApplicationTools::getDoubleParameter("optimization.tolerance", bppdist.getParams(), .000001);
     ApplicationTools::displayResult("Tolerance", TextTools::toString(tolerance));
 	
+    size_t nbThreads = ParallelTools::getNumberOfThreads(bppdist.getParams());
+
+    string inputMatrixPath = ApplicationTools::getAFilePath("input.matrix.file", bppdist.getParams(), false, true, "", false);
+    string matrixPath = ApplicationTools::getAFilePath("output.matrix.file", bppdist.getParams(), false, false, "", false);
+    string format = "";
+    std::map<std::string, std::string> unparsedArguments_;
+    if (matrixPath != "none")
+    {
+      string matrixFormat = ApplicationTools::getAFilePath("output.matrix.format", bppdist.getParams(), false, false, "", false);
+      KeyvalTools::parseProcedure(matrixFormat, format, unparsedArguments_);
+    }
+
+    // Distances are kept in double precision, unless the binary format or
+    // the neighbor joining heuristics, which use single precision, are
+    // requested:
+    bool singlePrecision = inputMatrixPath != "none"
+                           || format == TriangularDistanceMatrix::FORMAT_NAME
+                           || method == "rapidnj" || method == "fastnj";
+    ApplicationTools::displayResult("Distances precision", singlePrecision ? "single" : "double");
+
     //Here it is:
     ofstream warn("warnings", ios::out);
     ApplicationTools::warning=std::shared_ptr<OutputStream>(dynamic_cast<OutputStream*>(new StlOutputStreamWrapper(&warn))); 
-   tree = OptimizationTools::buildDistanceTree(distEstimation, *distMethod, parametersToIgnore, !ignoreBrLen, type, tolerance, nbEvalMax, profiler, messenger, optVerbose);
+    std::shared_ptr<const TriangularDistanceMatrix> matrix;
+    if (inputMatrixPath != "none")
+    {
+      // Distances were computed beforehand, and saved in the binary format:
+      ApplicationTools::displayResult("Input matrix file", inputMatrixPath);
+      matrix = TriangularDistanceMatrix::read(inputMatrixPath);
+      if (matrix->getNames() != sites->getSequenceNames())
+        throw Exception("The sequences of the input matrix are not those of the alignment.");
+      setDistanceMatrix(*distMethod, matrix);
+      distMethod->computeTree();
+      tree = distMethod->getTree();
+    }
+    else if (type == OptimizationTools::DISTANCEMETHOD_ITERATIONS)
+    {
+      auto tm = dynamic_pointer_cast<TransitionModelInterface>(model);
+      PatternDistanceEstimation patterns(*sites);
+      if (tm && ignoreBrLen && patterns.isCompatible(*tm))
+      {
+        // Branch lengths are not fitted: distances are estimated in
+        // parallel, starting from those of the previous round, and rounds
+        // stop as soon as the topology does not change anymore.
+        unsigned int maxRounds = ApplicationTools::getParameter<unsigned int>("optimization.max_number_of_rounds", bppdist.getParams(), 100);
+        BipartitionCounter bipartitions(sites->getSequenceNames());
+        vector<BipartitionCounter::Split> previousSplits;
+        for (unsigned int round = 1; ; ++round)
+        {
+          ApplicationTools::displayResult("Round", round);
+          matrix = patterns.computeMatrix(*tm, *rDist, nbThreads, matrix.get(), optVerbose, singlePrecision);
+          setDistanceMatrix(*distMethod, matrix);
+          distMethod->computeTree();
+          tree = distMethod->getTree();
+
+          vector<BipartitionCounter::Split> splits;
+          for (auto& split : bipartitions.getSplits(*tree))
+            splits.push_back(split.second);
+          sort(splits.begin(), splits.end());
+          if (round > 1 && splits == previousSplits)
+          {
+            ApplicationTools::displayResult("Topology unchanged after round", round);
+            break;
+          }
+          if (round == maxRounds)
+          {
+            ApplicationTools::displayWarning("Topology still changing after " + TextTools::toString(maxRounds) + " rounds.");
+            break;
+          }
+          previousSplits.swap(splits);
+
+          // Fit model and rate distribution parameters on the tree, with
+          // its branch lengths kept fixed and site patterns shared between
+          // threads.
+          auto lik = make_shared<PatternTreeLikelihood>(patterns, *tree, *tm, *rDist, nbThreads);
+          ParameterList parameters = lik->getParameters();
+          parameters.deleteParameters(parametersToIgnore.getParameterNames(), false);
+          if (parameters.size() > 0)
+          {
+            SimpleMultiDimensions optimizer(lik);
+            optimizer.setProfiler(profiler);
+            optimizer.setMessageHandler(messenger);
+            optimizer.setMaximumNumberOfEvaluations(nbEvalMax);
+            optimizer.getStopCondition()->setTolerance(tolerance);
+            optimizer.setConstraintPolicy(AutoParameter::CONSTRAINTS_AUTO);
+            optimizer.setVerbose(optVerbose);
+            optimizer.init(parameters);
+            optimizer.optimize();
+            model->matchParametersValues(lik->getParameters());
+            rDist->matchParametersValues(lik->getParameters());
+          }
+          ApplicationTools::displayResult("Log likelihood", TextTools::toString(lik->getLogLikelihood(), 15));
+        }
+      }
+      else
+      {
+        tree = OptimizationTools::buildDistanceTree(distEstimation, *distMethod, parametersToIgnore, !ignoreBrLen, type, tolerance, nbEvalMax, profiler, messenger, optVerbose);
+        matrix = make_shared<TriangularDistanceMatrix>(*distEstimation.getMatrix(), singlePrecision);
+      }
+    }
+    else
+    {
+      if (type == OptimizationTools::DISTANCEMETHOD_INIT && BitParallelDistanceEstimation::isSupported(*model, *rDist))
+      {
+        // Distances only depend on counts of differences between sequences:
+        BitParallelDistanceEstimation bitEstimation(*sites);
+        if (!bitEstimation.hasPartiallyResolvedCharacters())
+          matrix = bitEstimation.computeMatrix(*model, nbThreads, optVerbose, singlePrecision);
+      }
+      if (!matrix)
+      {
+        // Pairs of sequences are independent, and estimated in parallel:
+        ParallelDistanceEstimation parallelEstimation(model, rDist, sites, nbThreads, optVerbose);
+        matrix = parallelEstimation.computeMatrix(type == OptimizationTools::DISTANCEMETHOD_PAIRWISE, parametersToIgnore, singlePrecision);
+      }
+      setDistanceMatrix(*distMethod, matrix);
+      distMethod->computeTree();
+      tree = distMethod->getTree();
+    }
     warn.close();
 //    delete ApplicationTools::warning;
     ApplicationTools::warning = ApplicationTools::message;
 
-    string matrixPath = ApplicationTools::getAFilePath("output.matrix.file", bppdist.getParams(), false, false, "", false);
     if (matrixPath != "none")
     {
       ApplicationTools::displayResult("Output matrix file", matrixPath);
-      string matrixFormat = ApplicationTools::getAFilePath("output.matrix.format", bppdist.getParams(), false, false, "", false);
-      string format = "";
       bool extended = false;
-      std::map<std::string, std::string> unparsedArguments_;
-      KeyvalTools::parseProcedure(matrixFormat, format, unparsedArguments_);
-      if (unparsedArguments_.find("type") != unparsedArguments_.end())
+      if (format == TriangularDistanceMatrix::FORMAT_NAME)
+      {
+        ApplicationTools::displayResult("Output matrix format", format);
+        matrix->write(matrixPath);
+      }
+      else
       {
-        if (unparsedArguments_["type"] == "extended")
+        if (unparsedArguments_.find("type") != unparsedArguments_.end())
         {
-          extended = true;
-        }     
-        else if (unparsedArguments_["type"] == "classic")
-          extended = false;
+          if (unparsedArguments_["type"] == "extended")
+          {
+            extended = true;
+          }     
+          else if (unparsedArguments_["type"] == "classic")
+            extended = false;
+          else
+            ApplicationTools::displayWarning("Argument '" +
+                                             unparsedArguments_["type"] + "' for parameter 'Phylip#type' is unknown. " +
+                                             "Default used instead: not extended.");
+        }    
         else
-          ApplicationTools::displayWarning("Argument '" +
-                                           unparsedArguments_["type"] + "' for parameter 'Phylip#type' is unknown. " +
-                                           "Default used instead: not extended.");
-      }    
-      else
-        ApplicationTools::displayWarning("Argument 'Phylip#type' not found. Default used instead: not extended.");
+          ApplicationTools::displayWarning("Argument 'Phylip#type' not found. Default used instead: not extended.");
     
-      ODistanceMatrix* odm = IODistanceMatrixFactory().createWriter(IODistanceMatrixFactory::PHYLIP_FORMAT, extended);
-      odm->writeDistanceMatrix(*distEstimation.getMatrix(), matrixPath, true);
-      delete odm;
+        ODistanceMatrix* odm = IODistanceMatrixFactory().createWriter(IODistanceMatrixFactory::PHYLIP_FORMAT, extended);
+        odm->writeDistanceMatrix(*matrix->toDistanceMatrix(), matrixPath, true);
+        delete odm;
+      }
     }
     PhylogeneticsApplicationTools::writeTree(*tree, bppdist.getParams());
   
@@ -315,6 +477,8 @@ int main(int args, char ** argv)
         ignoreBrLen = true;
       }
       bool bootstrapVerbose = ApplicationTools::getBooleanParameter("bootstrap.verbose", bppdist.getParams(), false, "", true, false);
+      if (nbThreads > 1)
+        bootstrapVerbose = false;
  
       string bsTreesPath = ApplicationTools::getAFilePath("bootstrap.output.file", bppdist.getParams(), false, false);
       ofstream *out = NULL;
@@ -324,37 +488,111 @@ int main(int args, char ** argv)
         out = new ofstream(bsTreesPath.c_str(), ios::out);
       }
       Newick newick;
-    
-      vector<std::unique_ptr<Tree> > bsTrees(nbBS);
-      ApplicationTools::displayTask("Bootstrapping", true);
-      for(unsigned int i = 0; i < nbBS; i++)
+
+      // With the approximate bootstrap, model parameters are not estimated,
+      // and replicates are computed by reweighting the site patterns of the
+      // alignment rather than by copying sites.
+      unique_ptr<PatternDistanceEstimation> patterns;
+      if (approx)
       {
-        ApplicationTools::displayGauge(i, nbBS-1, '=');
-        shared_ptr<VectorSiteContainer> sample = SiteContainerTools::bootstrapSites(*sites);
-        auto tm=dynamic_pointer_cast<TransitionModelInterface>(model);
-        if (approx && tm)
-          tm->setFreqFromData(*sample);
-        distEstimation.setData(sample);
-        bsTrees[i] = OptimizationTools::buildDistanceTree(
-          distEstimation,
-          *distMethod,
-          parametersToIgnore,
-          ignoreBrLen,
-          type,
-          tolerance,
-          nbEvalMax,
-          NULL,
-          NULL,
-          (bootstrapVerbose ? 1 : 0)
-          );
-        if(out && i == 0) newick.writeTree(*bsTrees[i], bsTreesPath, true);
-        if(out && i >  0) newick.writeTree(*bsTrees[i], bsTreesPath, false);
+        patterns = make_unique<PatternDistanceEstimation>(*sites);
+        if (patterns->isCompatible(*model))
+          ApplicationTools::displayResult("Number of site patterns", patterns->getNumberOfPatterns());
+        else
+          patterns.reset();
       }
+
+      // Each worker has its own copies of the model, rate distribution,
+      // estimation and tree building method.
+      struct BootstrapWorker
+      {
+        std::shared_ptr<BranchModelInterface> model;
+        std::shared_ptr<DiscreteDistributionInterface> rDist;
+        std::unique_ptr<DistanceEstimation> estimation;
+        std::unique_ptr<AgglomerativeDistanceMethodInterface> method;
+      };
+      vector<BootstrapWorker> workers(min(static_cast<size_t>(nbBS), nbThreads));
+      for (auto& worker : workers)
+      {
+        worker.model = std::shared_ptr<BranchModelInterface>(model->clone());
+        worker.rDist = std::shared_ptr<DiscreteDistributionInterface>(rDist->clone());
+        worker.estimation = make_unique<DistanceEstimation>(worker.model, worker.rDist, sites, 1, false);
+        worker.method = std::unique_ptr<AgglomerativeDistanceMethodInterface>(dynamic_cast<AgglomerativeDistanceMethodInterface*>(distMethod->clone()));
+      }
+
+      // Samples are drawn from seeds picked beforehand, so that replicates
+      // do not depend on the number of threads.
+      size_t nbSites = sites->getNumberOfSites();
+      vector<unsigned int> seeds(nbBS);
+      for (auto& seed : seeds)
+        seed = RandomTools::giveIntRandomNumberBetweenZeroAndEntry<unsigned int>(numeric_limits<unsigned int>::max());
+
+      // Bipartitions of each replicate are counted as soon as it is done, and
+      // the tree is then released:
+      BipartitionCounter bipartitions(tree->getLeavesNames());
+      vector<std::unique_ptr<Tree> > bsTrees(nbBS);
+      vector<bool> finished(nbBS, false);
+      size_t nbDone = 0;
+      size_t nbCounted = 0;
+      ApplicationTools::displayTask("Bootstrapping", true);
+      ParallelTools::parallelFor(nbBS, nbThreads,
+        [&](size_t i, size_t w)
+        {
+          BootstrapWorker& worker = workers[w];
+          std::mt19937 generator(seeds[i]);
+          if (patterns)
+          {
+            vector<unsigned int> counts = patterns->drawBootstrapCounts(generator);
+            auto tm = dynamic_pointer_cast<TransitionModelInterface>(worker.model);
+            map<int, double> freqs = patterns->getFrequencies(counts);
+            tm->setFreq(freqs);
+            setDistanceMatrix(*worker.method, patterns->computeMatrix(*tm, *worker.rDist, counts, singlePrecision));
+            worker.method->computeTree();
+            bsTrees[i] = worker.method->getTree();
+            return;
+          }
+          std::uniform_int_distribution<size_t> pickSite(0, nbSites - 1);
+          vector<size_t> positions(nbSites);
+          for (auto& pos : positions)
+            pos = pickSite(generator);
+          shared_ptr<VectorSiteContainer> sample = SiteContainerTools::sampleSites(*sites, positions);
+          
+          auto tm=dynamic_pointer_cast<TransitionModelInterface>(worker.model);
+          if (approx && tm)
+            tm->setFreqFromData(*sample);
+          worker.estimation->setData(sample);
+          bsTrees[i] = OptimizationTools::buildDistanceTree(
+            *worker.estimation,
+            *worker.method,
+            parametersToIgnore,
+            ignoreBrLen,
+            type,
+            tolerance,
+            nbEvalMax,
+            NULL,
+            NULL,
+            (bootstrapVerbose ? 1 : 0)
+            );
+        },
+        [&](size_t i)
+        {
+          ApplicationTools::displayGauge(nbDone++, nbBS-1, '=');
+          finished[i] = true;
+          // Trees are written in replicate order:
+          while (nbCounted < nbBS && finished[nbCounted])
+          {
+            if (out)
+              newick.writeTree(*bsTrees[nbCounted], bsTreesPath, nbCounted == 0);
+            bipartitions.addTree(*bsTrees[nbCounted]);
+            bsTrees[nbCounted].reset();
+            nbCounted++;
+          }
+        });
       if(out) out->close();
       if(out) delete out;
       ApplicationTools::displayTaskDone();
       ApplicationTools::displayTask("Compute bootstrap values");
-      TreeTools::computeBootstrapValues(*tree, bsTrees);
+      bipartitions.computeBootstrapValues(*tree);
       ApplicationTools::displayTaskDone();
 
       //Write resulting tree:
@@ -40,8 +40,13 @@
 */
 
 // From the STL:
+#include <algorithm>
 #include <iostream>
 #include <iomanip>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <unordered_set>
 
 using namespace std;
 
@@ -50,6 +55,7 @@ using namespace std;
 #include <Bpp/App/BppApplication.h>
 #include <Bpp/App/ApplicationTools.h>
 #include <Bpp/Text/TextTools.h>
+#include <Bpp/Numeric/Random/RandomTools.h>
 
 // From bpp-seq:
 #include <Bpp/Seq/Alphabet/Alphabet.h>
@@ -63,10 +69,27 @@ using namespace std;
 #include <Bpp/Phyl/App/PhylogeneticsApplicationTools.h>
 #include <Bpp/Phyl/OptimizationTools.h>
 #include <Bpp/Phyl/Io/Newick.h>
-#include <Bpp/Phyl/Parsimony/DRTreeParsimonyScore.h>
+
+#include "BipartitionCounter.h"
+#include "FitchParsimony.h"
+#include "PackedAlignment.h"
+#include "ParallelTools.h"
+#include "ParsimonySearch.h"
 
 using namespace bpp;
 
+struct TopologyHash
+{
+  size_t operator()(const vector<BipartitionCounter::Split>& topology) const
+  {
+    BipartitionCounter::SplitHash splitHash;
+    size_t hash = topology.size();
+    for (const auto& split : topology)
+      hash = hash * 31 + splitHash(split);
+    return hash;
+  }
+};
+
 void help()
 {
   (*ApplicationTools::message << "__________________________________________________________________________").endLine();
@@ -102,7 +125,7 @@ int main(int args, char ** argv)
     bool includeGaps = ApplicationTools::getBooleanParameter("use.gaps", bpppars.getParams(), false, "", false, false);
     ApplicationTools::displayBooleanResult("Use gaps", includeGaps);
 
-    auto allSites = SequenceApplicationTools::getSiteContainer(alphabet, bpppars.getParams());
+    auto allSites = PackedAlignment::getSiteContainer(alphabet, bpppars.getParams());
 	
     shared_ptr<VectorSiteContainer> sites = SequenceApplicationTools::getSitesToAnalyse(* allSites, bpppars.getParams(), "", true, !includeGaps, true);
 
@@ -112,32 +135,118 @@ int main(int args, char ** argv)
     if (sites->getNumberOfSequences()==0 || sites->getNumberOfSites()==0)
       throw Exception("Empty data.");
 
-    // Get the initial tree
+    ApplicationTools::displayTask("Initializing parsimony");
+    FitchParsimony parsimony(*sites, includeGaps);
+    ApplicationTools::displayTaskDone();
+    ApplicationTools::displayResult("Number of costly site patterns", TextTools::toString(parsimony.getNumberOfPatterns()));
+
+    bool optimizeTopo = ApplicationTools::getBooleanParameter("optimization.topology", bpppars.getParams(), false, "", true, 1);
+    ApplicationTools::displayBooleanResult("Optimize topology", optimizeTopo);
+
     std::shared_ptr<Tree> tree = nullptr;
-    string initTreeOpt = ApplicationTools::getStringParameter("init.tree", bpppars.getParams(), "user", "", false, false);
-    ApplicationTools::displayResult("Input tree", initTreeOpt);
-    if (initTreeOpt == "user")
+    if (!optimizeTopo)
     {
-      tree = PhylogeneticsApplicationTools::getTree(bpppars.getParams());
-      ApplicationTools::displayResult("Number of leaves", TextTools::toString(tree->getNumberOfLeaves()));
+      // Get the initial tree
+      string initTreeOpt = ApplicationTools::getStringParameter("init.tree", bpppars.getParams(), "user", "", false, false);
+      ApplicationTools::displayResult("Input tree", initTreeOpt);
+      if (initTreeOpt == "user")
+      {
+        tree = PhylogeneticsApplicationTools::getTree(bpppars.getParams());
+        ApplicationTools::displayResult("Number of leaves", TextTools::toString(tree->getNumberOfLeaves()));
+      }
+      else if (initTreeOpt == "random")
+      {
+        vector<string> names = sites->getSequenceNames();
+        tree = TreeTemplateTools::getRandomTree(names, false);
+        tree->setBranchLengths(1.);
+      }
+      else throw Exception("Unknown init tree method.");
+
+      unsigned int score = parsimony.getScore(*tree);
+      ApplicationTools::displayResult("Initial parsimony score", TextTools::toString(score));
     }
-    else if (initTreeOpt == "random")
+    else
     {
-      vector<string> names = sites->getSequenceNames();
-      tree = TreeTemplateTools::getRandomTree(names, false);
-      tree->setBranchLengths(1.);
+      size_t nbReplicates = ApplicationTools::getParameter<size_t>("optimization.topology.replicates", bpppars.getParams(), 10, "", true, 1);
+      if (nbReplicates == 0)
+        throw Exception("At least one replicate is needed for the topology search.");
+      ApplicationTools::displayResult("Number of random addition replicates", nbReplicates);
+      size_t nbThreads = ParallelTools::getNumberOfThreads(bpppars.getParams());
+
+      // Addition orders are drawn from seeds picked beforehand, so that
+      // results do not depend on the number of threads.
+      vector<unsigned int> seeds(nbReplicates);
+      for (auto& seed : seeds)
+        seed = RandomTools::giveIntRandomNumberBetweenZeroAndEntry<unsigned int>(numeric_limits<unsigned int>::max());
+
+      // Most parsimonious trees are kept once per topology, in replicate
+      // order, a topology being the sorted list of its bipartitions.
+      BipartitionCounter bipartitions(parsimony.getNames());
+      unordered_set<vector<BipartitionCounter::Split>, TopologyHash> topologies;
+      vector<unique_ptr<TreeTemplate<Node>>> bestTrees;
+      unsigned int bestScore = 0;
+
+      vector<unsigned int> scores(nbReplicates);
+      vector<size_t> nbUpdates(nbReplicates);
+      vector<size_t> nbMoves(nbReplicates);
+      vector<unique_ptr<TreeTemplate<Node>>> trees(nbReplicates);
+      vector<bool> finished(nbReplicates, false);
+      size_t nbDone = 0;
+      size_t nbCounted = 0;
+      ApplicationTools::displayTask("Searching trees", true);
+      ParallelTools::parallelFor(nbReplicates, nbThreads,
+        [&](size_t i, size_t)
+        {
+          std::mt19937 generator(seeds[i]);
+          ParsimonySearch search(parsimony);
+          search.buildRandomAdditionTree(generator);
+          scores[i] = search.optimizeSPR();
+          trees[i] = search.getTree();
+          nbUpdates[i] = search.getNumberOfUpdates();
+          nbMoves[i] = search.getNumberOfEvaluatedMoves();
+        },
+        [&](size_t i)
+        {
+          ApplicationTools::displayGauge(nbDone++, nbReplicates - 1, '=');
+          finished[i] = true;
+          while (nbCounted < nbReplicates && finished[nbCounted])
+          {
+            if (bestTrees.empty() || scores[nbCounted] < bestScore)
+            {
+              bestScore = scores[nbCounted];
+              bestTrees.clear();
+              topologies.clear();
+            }
+            if (scores[nbCounted] == bestScore)
+            {
+              vector<BipartitionCounter::Split> topology;
+              for (const auto& split : bipartitions.getSplits(*trees[nbCounted]))
+                topology.push_back(split.second);
+              sort(topology.begin(), topology.end());
+              if (topologies.insert(topology).second)
+                bestTrees.push_back(std::move(trees[nbCounted]));
+            }
+            trees[nbCounted].reset();
+            nbCounted++;
+          }
+        });
+      ApplicationTools::displayTaskDone();
+      ApplicationTools::displayResult("Best parsimony score", TextTools::toString(bestScore));
+      ApplicationTools::displayResult("Number of most parsimonious trees", bestTrees.size());
+      ApplicationTools::displayResult("Number of SPR moves evaluated", accumulate(nbMoves.begin(), nbMoves.end(), size_t(0)));
+      ApplicationTools::displayResult("Number of state sets computed", accumulate(nbUpdates.begin(), nbUpdates.end(), size_t(0)));
+
+      string mpTreesPath = ApplicationTools::getAFilePath("output.trees.file", bpppars.getParams(), false, false, "", true, "none", 1);
+      if (mpTreesPath != "none")
+      {
+        ApplicationTools::displayResult("Most parsimonious trees stored in file", mpTreesPath);
+        Newick newick;
+        for (size_t i = 0; i < bestTrees.size(); ++i)
+          newick.writeTree(*bestTrees[i], mpTreesPath, i == 0);
+      }
+      tree = std::move(bestTrees[0]);
     }
-    else throw Exception("Unknown init tree method.");
-	
-    ApplicationTools::displayTask("Initializing parsimony");
-    auto treen = make_shared<TreeTemplate<Node>>(*tree);
-    auto tp = std::make_unique<DRTreeParsimonyScore>(treen, sites, false, includeGaps);
 
-    ApplicationTools::displayTaskDone();
-    double score = tp->getScore();
-    ApplicationTools::displayResult("Initial parsimony score", TextTools::toString(score, 15));
-    tree = make_shared<TreeTemplate<Node>>(tp->tree());
-  
     PhylogeneticsApplicationTools::writeTree(*tree, bpppars.getParams());
   
     bpppars.done();
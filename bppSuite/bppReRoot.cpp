@@ -39,7 +39,9 @@ knowledge of the CeCILL license and that you accept its terms.
 */
 
 // From the STL:
+#include <algorithm>
 #include <iostream>
+#include <memory>
 
 using namespace std;
 
@@ -60,6 +62,10 @@ using namespace std;
 #include <Bpp/Phyl/Io/Newick.h>
 #include <Bpp/Phyl/App/PhylogeneticsApplicationTools.h>
 
+#include "NewickTreeReader.h"
+#include "OutgroupRerooter.h"
+#include "ParallelTools.h"
+
 using namespace bpp;
 
 typedef TreeTemplate<Node> MyTree;
@@ -113,11 +119,6 @@ int main(int args, char ** argv)
   bool printOption = ApplicationTools::getBooleanParameter("print.option", bppreroot.getParams(), false);
   bool tryAgain = ApplicationTools::getBooleanParameter("tryAgain.option", bppreroot.getParams(), true);
           
-  vector<Tree*> tempTrees;
-  vector<MyTree*> trees;
-
-  //ApplicationTools::displayResult("Number of trees found", TextTools::toString(trees.size()));
-            
   const string path = outgroupsPath;  
   ifstream file(path.c_str(), ios::in);
   string temp, description, taxon;
@@ -138,177 +139,66 @@ int main(int args, char ** argv)
   }
   file.close();  
   
-  const string path2 = listPath;  
-  ifstream treePath(path2.c_str(), ios::in);  
-
-  if (!treePath) { throw IOException ("Newick::read: failed to read from stream"); }
-
-  string temp2, description2;// Initialization
-  string::size_type index;  
-  
-  int k = 0;
-  
-  while (!treePath.eof())
+  size_t nbThreads = ParallelTools::getNumberOfThreads(bppreroot.getParams());
+
+  OutgroupRerooter rerooter(levelOutgroup, tryAgain);
+  NewickTreeReader reader(listPath);
+
+  // Trees are read by batches in the main thread, rerooted by the workers,
+  // and written in the order of the input file:
+  vector<NewickTreeReader::Description> batch(100 * nbThreads);
+  vector< unique_ptr<MyTree> > rootedTrees(batch.size());
+  vector<char> found(batch.size());
+  vector<char> finished(batch.size());
+  size_t k = 0;
+  bool firstWrite = true;
+  bool hasMore = true;
+  while (hasMore)
   {
-    k++;
-    bool printOrNot =true;
-    unique_ptr<Tree> tempTree;
-
-    getline(treePath, temp2, '\n');  // Copy current line in temporary string
-   
-    index = temp2.find(";");
-    if (temp2 != "")
+    size_t nbInBatch = 0;
+    while (nbInBatch < batch.size() && (hasMore = reader.nextDescription(batch[nbInBatch])))
     {
-      if (index != string::npos)
-      {
-        description2 += temp2.substr(0, index + 1);
-        tempTree = TreeTemplateTools::parenthesisToTree(description2);    
-        description2 = temp2.substr(index + 1);       
-      }
-      else description2 += temp;
-
-      MyTree* tree = dynamic_cast <MyTree* >(tempTree.get());
-      //ApplicationTools::displayGauge(tr, trees.size() - 1, '=');
-
-      vector<string> leavesTree;      
-      leavesTree = (*tree).getLeavesNames();  
-  
-      size_t numNodes = tree->getNumberOfNodes() - 1;
-      size_t numNodeWithBranchLength = 0;
-      vector<Node *>  nodes = tree->getNodes();
-      for (size_t i = 0; i < nodes.size(); i++)
-      {
-        if(nodes[i]->hasDistanceToFather())
-          numNodeWithBranchLength++;
-      }
-      if ((numNodes != numNodeWithBranchLength) && (numNodeWithBranchLength != 0))\
-      {
-        cout << "Could not execute due to a source tree with missing branch lengths \n(reminder: a source tree must either have no branch length, either length for all branches\n";
-        exit(-1);
-      }
-      vector<string> outGroup;
-      bool found = false;
-      bool analyseOutgroupLevel = true;
-      for (size_t t = 0; t < levelOutgroup.size() && analyseOutgroupLevel; t++)
-      {      
-        outGroup.clear();
-        vector<string>::iterator Iterator;  
-        for(Iterator = levelOutgroup[t].begin(); Iterator != levelOutgroup[t].end(); Iterator++ )
+      nbInBatch++;
+    }
+    std::fill(finished.begin(), finished.end(), 0);
+    size_t nbWritten = 0;
+    ParallelTools::parallelFor(nbInBatch, nbThreads,
+      [&](size_t i, size_t) {
+        unique_ptr<MyTree> tree = NewickTreeReader::parse(batch[i]);
+
+        size_t numNodes = tree->getNumberOfNodes() - 1;
+        size_t numNodeWithBranchLength = 0;
+        vector<Node *>  nodes = tree->getNodes();
+        for (size_t j = 0; j < nodes.size(); j++)
         {
-          if(VectorTools::contains(leavesTree, *Iterator))
-          {
-            outGroup.push_back(*Iterator);
-          }
+          if(nodes[j]->hasDistanceToFather())
+            numNodeWithBranchLength++;
         }
-        if(outGroup.size() > 0)
+        if ((numNodes != numNodeWithBranchLength) && (numNodeWithBranchLength != 0))
+          throw Exception("Could not execute due to a source tree with missing branch lengths \n(reminder: a source tree must either have no branch length, either length for all branches");
+
+        found[i] = rerooter.reroot(tree);
+        if (found[i])
+          tree->resetNodesId();
+        rootedTrees[i] = std::move(tree);
+      },
+      [&](size_t i) {
+        finished[i] = 1;
+        for (; nbWritten < nbInBatch && finished[nbWritten]; nbWritten++)
         {
-          vector<string> remainingTaxa;
-          VectorTools::diff(leavesTree, outGroup, remainingTaxa);
-          if(remainingTaxa.size() > 0)
+          k++;
+          if (!found[nbWritten])
+            cout << "Sorry but I can't root your tree " << k << " ; or none of the taxa in your list is present in the tree or the outgroup is not monophyletic!\n";
+          if (found[nbWritten] || printOption)
           {
-            tree->newOutGroup(tree->getNode(remainingTaxa[0]));
-            Node * newRoot = tree->getNode(outGroup[0]);
-            vector<string>  tempLeaves = TreeTemplateTools::getLeavesNames(* newRoot);
-           
-            while(newRoot->hasFather() && !(VectorTools::containsAll(tempLeaves, outGroup)))
-            {   
-              newRoot = newRoot->getFather();
-              tempLeaves = TreeTemplateTools::getLeavesNames(* newRoot);
-            }
-          
-            tempLeaves = TreeTemplateTools::getLeavesNames(* newRoot);
-            std::sort(tempLeaves.begin(), tempLeaves.end());
-      
-            if(tempLeaves.size() == outGroup.size())
-            {
-              tree->newOutGroup(newRoot);
-              found = true;
-              analyseOutgroupLevel = false;
-            }
-            else
-            {
-              bool monophylOk = true;
-
-              for (size_t f = 0; f < newRoot->getNumberOfSons() && monophylOk; f++)
-              {
-                tempLeaves = TreeTemplateTools::getLeavesNames(*newRoot->getSon(f));
-                vector<string> diff;
-                VectorTools::diff(outGroup, tempLeaves, diff);
-
-                size_t difference = diff.size();
-                if (!( (difference == 0) || (difference == tempLeaves.size()) ) )
-                {
-                  //The proposed outgroup is not monophyletic. The analysis for this tree is interrupted
-                  //No more outgroup are analysed
-                  monophylOk = false;
-                }
-              }
-              if (monophylOk)
-              {
-                tempLeaves = TreeTemplateTools::getLeavesNames(* newRoot);
-
-                std::sort(tempLeaves.begin(), tempLeaves.end());      
-                if (tempLeaves.size() != leavesTree.size())
-                {
-                  MyTree* low = new MyTree(TreeTemplateTools::cloneSubtree<Node>(* newRoot));
-                  tree->newOutGroup(newRoot);
-                  Node* sonUpper;
-                  vector<string>  tempLeaves2 = TreeTemplateTools::getLeavesNames(* (tree->getRootNode())->getSon(0));
-                  std::sort(tempLeaves2.begin(), tempLeaves2.end());
-                  if((VectorTools::vectorIntersection(tempLeaves2,outGroup).size()) !=0)
-                  {
-                    sonUpper = (tree->getRootNode())->getSon(1);
-                  }
-                  else
-                  {
-                    sonUpper = (tree->getRootNode())->getSon(0);
-                  }
-                  int ident = TreeTools::getMaxId(*low, low->getRootId());
-                  vector <Node *> nodesTemp= TreeTemplateTools::getNodes( * sonUpper);
-                  for(size_t F = 0; F < nodesTemp.size(); F++)
-                    nodesTemp[F]->setId(ident + static_cast<int>(F + 1));
-                  low->getRootNode()->addSon(sonUpper);
-                  tree = low;
-                }
-                //A good outgroup was found
-
-                found = true;
-                analyseOutgroupLevel = false;
-              }
-            }                  
+            newick.writeTree(*rootedTrees[nbWritten], outputPath, firstWrite);
+            firstWrite = false;
           }
-          if(!tryAgain)
-            analyseOutgroupLevel = false;
-        }    
-      }
-      if (!found)
-      {  
-        if(!printOption)
-          printOrNot = false;
-        else
-          printOrNot = true;
-        cout << "Sorry but I can't root your tree " << k << " ; or none of the taxa in your list is present in the tree or the outgroup is not monophyletic!\n";
-      }
-      else
-      {
-        printOrNot = (true);
-        tree->resetNodesId();
-      }
-      if (printOrNot)
-      {
-        if(k == 1)
-          newick.writeTree(* tree, outputPath, true);
-        else
-          newick.writeTree(* tree, outputPath, false);
-      }  
-
-      delete tree;
-    }
+          rootedTrees[nbWritten].reset();
+        }
+      });
   }
-  ApplicationTools::displayTaskDone();
-     
-  //Write rooted trees:  
-  for (size_t i = 0; i < trees.size(); i++) delete trees[i];
+  ApplicationTools::displayResult("Number of trees rerooted", k);
     
   bppreroot.done();
   }
@@ -41,17 +41,19 @@
 #include <iostream>
 #include <fstream>
 #include <iomanip>
+#include <algorithm>
+#include <functional>
 
 using namespace std;
 
 // From bpp-core:
 #include <Bpp/Version.h>
-#include <Bpp/Numeric/DataTable.h>
 #include <Bpp/Text/KeyvalTools.h>
 #include <Bpp/App/NumCalcApplicationTools.h>
 
 // From bpp-seq:
 #include <Bpp/Seq/SequenceTools.h>
+#include <Bpp/Seq/Container/SiteContainer.h>
 #include <Bpp/Seq/Io/BppOAlignmentWriterFormat.h>
 
 // From bpp-phy:
@@ -66,8 +68,61 @@ using namespace std;
 #include <Bpp/Phyl/Likelihood/PhyloLikelihoods/OneProcessSequencePhyloLikelihood.h>
 #include <Bpp/Phyl/Likelihood/PhyloLikelihoods/SingleProcessPhyloLikelihood.h>
 
+#include "AliasTable.h"
+#include "BlockAlignmentWriter.h"
+#include "BlockStateSampler.h"
+#include "PackedAlignment.h"
+#include "ParallelTools.h"
+#include "PosteriorSequenceSampler.h"
+#include "SiteInfosReader.h"
+
 using namespace bpp;
 
+// Number of sites of which root states are sampled together, when they
+// are drawn from a probabilistic sequence.
+const size_t ROOT_SAMPLING_BLOCK_SIZE = 4096;
+
+/**
+ * @brief Get the positions described by input.site.selection.
+ *
+ * getNbSites() gives the total number of sites. It is only called for
+ * negative indices and samples, since it may require a pass over a file.
+ */
+vector<size_t> getSiteSelection(const string& siteSet, const function<size_t()>& getNbSites)
+{
+  vector<size_t> vSite;
+  try {
+    vector<int> vSite1 = NumCalcApplicationTools::seqFromString(siteSet,",",":");
+    for (size_t i = 0; i < vSite1.size(); ++i){
+      int x = (vSite1[i] >= 0 ? vSite1[i] : static_cast<int>(getNbSites()) + vSite1[i]);
+      if (x >= 0)
+        vSite.push_back(static_cast<size_t>(x));
+      else
+        throw Exception("bppseqgen. Incorrect negative index for site selection: " + TextTools::toString(x));
+    }
+  }
+  catch (Exception& e)
+  {
+    string seln;
+    map<string, string> selArgs;
+    KeyvalTools::parseProcedure(siteSet, seln, selArgs);
+    if (seln == "Sample")
+    {
+      size_t nbSites = getNbSites();
+      size_t n = ApplicationTools::getParameter<size_t>("n", selArgs, nbSites, "", true, 1);
+      bool replace = ApplicationTools::getBooleanParameter("replace", selArgs, false, "", true, 1);
+
+      vSite.resize(n);
+      vector<size_t> vPos;
+      for (size_t p = 0; p < nbSites; ++p)
+        vPos.push_back(p);
+
+      RandomTools::getSample(vPos, vSite, replace);
+    }
+  }
+  return vSite;
+}
+
 int main(int args, char ** argv)
 {
   cout << "******************************************************************" << endl;
@@ -129,6 +184,13 @@ int main(int args, char ** argv)
       ApplicationTools::displayWarning("Did not find any descriptor matching `simul*`, so no simulation performed.");
     }
   
+    // Posterior simulators along the data, per phylo number
+    map<size_t, shared_ptr<GivenDataSubstitutionProcessSequenceSimulator>> mGivenDataSimulators;
+    map<size_t, shared_ptr<PosteriorSequenceSampler>> mPosteriorSamplers;
+
+    // Posterior simulations along the data are sampled on several threads
+    size_t nbThreads = ParallelTools::getNumberOfThreads(bppseqgen.getParams());
+
     for (size_t nS=0; nS< vSimulName.size(); nS++)
     {
       size_t poseq=vSimulName[nS].find("=");
@@ -179,38 +241,10 @@ int main(int args, char ** argv)
 
         nbSites = data->getNumberOfSites();
         
+        vector<size_t> vSite;
         if (siteSet != "none")
         {
-          vector<size_t> vSite;
-          try {
-            vector<int> vSite1 = NumCalcApplicationTools::seqFromString(siteSet,",",":");
-            for (size_t i = 0; i < vSite1.size(); ++i){
-              int x = (vSite1[i] >= 0 ? vSite1[i] : static_cast<int>(nbSites) + vSite1[i]);
-              if (x >= 0)
-                vSite.push_back(static_cast<size_t>(x));
-              else
-                throw Exception("bppseqgen. Incorrect negative index for site selection: " + TextTools::toString(x));
-            }
-          }
-          catch (Exception& e)
-          {
-            string seln;
-            map<string, string> selArgs;
-            KeyvalTools::parseProcedure(siteSet, seln, selArgs);
-            if (seln == "Sample")
-            {
-              size_t n = ApplicationTools::getParameter<size_t>("n", selArgs, nbSites, "", true, 1);
-              bool replace = ApplicationTools::getBooleanParameter("replace", selArgs, false, "", true, 1);
-
-              vSite.resize(n);
-              vector<size_t> vPos;
-              for (size_t p = 0; p < nbSites; ++p)
-                vPos.push_back(p);
-
-              RandomTools::getSample(vPos, vSite, replace);
-            }
-          }
-
+          vSite = getSiteSelection(siteSet, [nbSites]() { return nbSites; });
           nbSites = vSite.size();
         }
 
@@ -220,16 +254,69 @@ int main(int args, char ** argv)
         withStates = true;
 
         size_t nbStates=alphabet->getSize();
-        std::vector<double> probstate(nbStates);
 
         auto resChar=alphabet->getResolvedChars();
 
-        for (size_t i = 0; i < nbSites; ++i) {
-          for (size_t j = 0; j< nbStates; j++) 
-            probstate[j]=data->getStateValueAt(i, nseq, alphabet->getIntCodeAt(j+1));
+        // Model states are looked up once per character
+        vector<vector<size_t>> charModelStates(resChar.size());
+        for (size_t j = 0; j < resChar.size(); j++)
+          charModelStates[j] = sm->getModelStates(resChar[j]);
+
+        vector<int> charCodes(nbStates);
+        for (size_t j = 0; j < nbStates; j++)
+          charCodes[j] = alphabet->getIntCodeAt(j+1);
 
-          auto pchar = RandomTools::pickOne<string>(resChar, probstate, true);
-          states[i] = RandomTools::pickOne<size_t>(sm->getModelStates(pchar));
+        vector<size_t> pchars(nbSites);
+        
+        auto sc = dynamic_cast<const SiteContainerInterface*>(data.get());
+        if (sc)
+        {
+          // Plain sequence: the sites with the same character share the
+          // alias table of their state distribution, so that each draw is O(1).
+          const auto& rootSeq = sc->sequence(nseq);
+          map<int, AliasTable> aliasTables;
+          std::vector<double> probstate(nbStates);
+
+          for (size_t i = 0; i < nbSites; ++i) {
+            size_t site = vSite.size() > 0 ? vSite[i] : i;
+            int code = rootSeq[site];
+            auto itTable = aliasTables.find(code);
+            if (itTable == aliasTables.end())
+            {
+              for (size_t j = 0; j< nbStates; j++) 
+                probstate[j]=data->getStateValueAt(site, nseq, charCodes[j]);
+              itTable = aliasTables.emplace(code, AliasTable(probstate)).first;
+            }
+            pchars[i] = itTable->second.pick();
+          }
+        }
+        else
+        {
+          // Probabilistic sequence: state probabilities are read and
+          // sampled by blocks of sites.
+          size_t blockSize = min(nbSites, ROOT_SAMPLING_BLOCK_SIZE);
+          if (blockSize > 0)
+          {
+            BlockStateSampler sampler(nbStates, blockSize);
+            vector<size_t> picks;
+            for (size_t first = 0; first < nbSites; first += blockSize)
+            {
+              size_t nbBlockSites = min(blockSize, nbSites - first);
+              for (size_t j = 0; j < nbStates; j++)
+                for (size_t i = 0; i < nbBlockSites; ++i)
+                {
+                  size_t site = vSite.size() > 0 ? vSite[first + i] : first + i;
+                  sampler.setProbability(i, j, data->getStateValueAt(site, nseq, charCodes[j]));
+                }
+              sampler.sample(nbBlockSites, picks);
+              std::copy(picks.begin(), picks.end(), pchars.begin() + static_cast<ptrdiff_t>(first));
+            }
+          }
+        }
+
+        for (size_t i = 0; i < nbSites; ++i) {
+          const vector<size_t>& modelStates = charModelStates[pchars[i]];
+          states[i] = modelStates[RandomTools::giveIntRandomNumberBetweenZeroAndEntry(modelStates.size())];
         }
       }
       else
@@ -239,87 +326,50 @@ int main(int args, char ** argv)
         if (infosFile != "none")
         {
           ApplicationTools::displayResult("Site information", infosFile);
-          ifstream in(infosFile.c_str());
-          auto infos = DataTable::read(in, "\t");
-          nbSites = infos->getNumberOfRows();
-//      ApplicationTools::displayResult("Number of sites", TextTools::toString(nbSites));
+          SiteInfosReader infos(infosFile);
           string rateCol = ApplicationTools::getStringParameter("input.infos.rates", argsim, "pr", "", true, true);
           string stateCol = ApplicationTools::getStringParameter("input.infos.states", argsim, "none", "", true, true);
           withRates = rateCol != "none";
           withStates = stateCol != "none";
 
-      
-          // Specific input data 
-          if (withRates)
+          // Only the selected rows of the requested columns are read
+          string siteSet = ApplicationTools::getStringParameter("input.site.selection", argsim, "none", "", true, 1);
+          vector<size_t> vSite;
+          if (siteSet != "none")
           {
-            rates.resize(nbSites);
-            vector<string> ratesStrings = infos->getColumn(rateCol);
-            for (size_t i = 0; i < nbSites; i++)
-            {
-              rates[i] = TextTools::toDouble(ratesStrings[i]);
-            }
+            // Rows are only counted if the selection needs it:
+            size_t nbRows = 0;
+            bool counted = false;
+            vSite = getSiteSelection(siteSet, [&]() {
+                if (!counted)
+                {
+                  nbRows = infos.getNumberOfRows();
+                  counted = true;
+                }
+                return nbRows;
+              });
           }
+
+          vector<int> ancestralStates;
+          if (siteSet == "none" || vSite.size() > 0)
+            infos.read(vSite, rateCol, stateCol, *alphabet, rates, ancestralStates);
+          nbSites = withRates ? rates.size() : ancestralStates.size();
+          
           if (withStates)
           {
-            vector<string> ancestralStates = infos->getColumn(stateCol);
-        
+            // Model states are looked up once per character
+            map<int, vector<size_t>> charModelStates;
             states.resize(nbSites);
             for (size_t i = 0; i < nbSites; i++)
             {
-              int alphabetState = alphabet->charToInt(ancestralStates[i]);
+              int alphabetState = ancestralStates[i];
               //If a generic character is provided, we pick one state randomly from the possible ones:
               if (alphabet->isUnresolved(alphabetState))
                 alphabetState = RandomTools::pickOne<int>(alphabet->getAlias(alphabetState));
-              states[i] = RandomTools::pickOne<size_t>(sm->getModelStates(alphabetState));
-            }
-
-            string siteSet = ApplicationTools::getStringParameter("input.site.selection", argsim, "none", "", true, 1);
-
-            if (siteSet != "none")
-            {
-              vector<size_t> vSite;
-              try {
-                vector<int> vSite1 = NumCalcApplicationTools::seqFromString(siteSet,",",":");
-                for (size_t i = 0; i < vSite1.size(); ++i){
-                  int x = (vSite1[i] >= 0 ? vSite1[i] : static_cast<int>(nbSites) + vSite1[i]);
-                  if (x >= 0)
-                    vSite.push_back(static_cast<size_t>(x));
-                  else
-                    throw Exception("bppseqgen : incorrect negative index: " + TextTools::toString(x));
-                }
-              }
-              catch (Exception& e)
-              {
-                string seln;
-                map<string, string> selArgs;
-                KeyvalTools::parseProcedure(siteSet, seln, selArgs);
-                if (seln == "Sample")
-                {
-                  size_t n = ApplicationTools::getParameter<size_t>("n", selArgs, nbSites, "", true, 1);
-                  bool replace = ApplicationTools::getBooleanParameter("replace", selArgs, false, "", true, 1);
-
-                  vSite.resize(n);
-                  vector<size_t> vPos;
-                  for (size_t p = 0; p < nbSites; ++p)
-                    vPos.push_back(p);
-
-                  RandomTools::getSample(vPos, vSite, replace);
-                }
-              }
-
-              nbSites = vSite.size();
-
-              vector<size_t> newStates(nbSites);
-              vector<double> newRates(nbSites);
-
-              for (size_t ni = 0; ni < nbSites; ++ni)
-              {
-                newStates[ni] = states[vSite[ni]];
-                newRates[ni]  = rates[vSite[ni]];
-              }
-
-              states = newStates;
-              rates = newRates;
+              auto itStates = charModelStates.find(alphabetState);
+              if (itStates == charModelStates.end())
+                itStates = charModelStates.emplace(alphabetState, sm->getModelStates(alphabetState)).first;
+              states[i] = RandomTools::pickOne<size_t>(itStates->second);
             }
           }
         }
@@ -328,7 +378,8 @@ int main(int args, char ** argv)
       ////////////////////////////////////
       /////// Process
 
-      unique_ptr<SequenceSimulatorInterface> ss;
+      shared_ptr<SequenceSimulatorInterface> ss;
+      shared_ptr<PosteriorSequenceSampler> posteriorSampler;
       
       if (argsim.find("process")!=argsim.end())
       {
@@ -372,8 +423,37 @@ int main(int args, char ** argv)
         std::shared_ptr<LikelihoodCalculationSingleProcess> lcsp = spph?spph->getLikelihoodCalculationSingleProcess():
           opsp->getLikelihoodCalculationSingleProcess();
 
-        if (argsim.find("pos")==argsim.end()) // Sequence simulation similar to the data, number_of_sites will not be used
-          ss= make_unique<GivenDataSubstitutionProcessSequenceSimulator>(lcsp);
+        // With one thread, the bpp-phyl simulator is used, so that a given
+        // seed gives the same sequences as before.
+        bool parallelPosterior = argsim.find("pos")==argsim.end() && nbThreads > 1;
+        if (parallelPosterior && (withStates || withRates || !PosteriorSequenceSampler::isSupported(*lcsp)))
+        {
+          ApplicationTools::displayWarning(string("bppseqgen. Sites cannot be sampled in parallel with ") + (withStates || withRates ? "rates or states from input.infos" : "mixed branch models") + ", and are simulated one after the other.");
+          parallelPosterior = false;
+        }
+
+        if (parallelPosterior)
+        {
+          // Sites are sampled in parallel from their posterior distributions.
+          // Transition probabilities are computed once per phylo.
+          auto itPs = mPosteriorSamplers.find(indPhylo);
+          if (itPs == mPosteriorSamplers.end())
+            itPs = mPosteriorSamplers.emplace(indPhylo, make_shared<PosteriorSequenceSampler>(lcsp)).first;
+          posteriorSampler = itPs->second;
+        }
+        else if (argsim.find("pos")==argsim.end()) // Sequence simulation similar to the data, number_of_sites will not be used
+        {
+          // Posterior tables are computed once per phylo, and shared by all
+          // the simulations using it.
+          auto itGds = mGivenDataSimulators.find(indPhylo);
+          if (itGds == mGivenDataSimulators.end())
+          {
+            ApplicationTools::displayTask(" Compute posterior tables");
+            itGds = mGivenDataSimulators.emplace(indPhylo, make_shared<GivenDataSubstitutionProcessSequenceSimulator>(lcsp)).first;
+            ApplicationTools::displayTaskDone();
+          }
+          ss = itGds->second;
+        }
         else
         {        
           size_t pos=(size_t)ApplicationTools::getIntParameter("pos", argsim, 1, "", true, 0);
@@ -400,26 +480,94 @@ int main(int args, char ** argv)
       auto gds = dynamic_cast<GivenDataSubstitutionProcessSequenceSimulator*>(ss.get());
       auto pps = dynamic_cast<SubstitutionProcessSequenceSimulator*>(ss.get());
       
-      size_t nbmin = gds?gds->getNumberOfSites():pps?pps->getNumberOfSites():100;
+      size_t nbmin = posteriorSampler?posteriorSampler->getNumberOfSites():gds?gds->getNumberOfSites():pps?pps->getNumberOfSites():100;
 
       nbSites = (size_t)ApplicationTools::getIntParameter("number_of_sites", argsim, (int)nbmin, "", false, 0);
       ApplicationTools::displayResult(" Number of sites", TextTools::toString(nbSites));
 
 
-      ss->outputInternalSequences(mintern);
-      std::shared_ptr<SiteContainerInterface> sites = 0;
-      
-      if (withStates || withRates)
+      size_t blockSize = ApplicationTools::getParameter<size_t>("output.block.size", argsim, 0, "", true, 1);
+      // Blocks are simulated independently, with site positions restarting
+      // at 0: this is only correct when all sites follow the same process.
+      if (blockSize > 0 && !dynamic_cast<SimpleSubstitutionProcessSequenceSimulator*>(ss.get()))
       {
-        auto pss=dynamic_cast<SubstitutionProcessSequenceSimulator*>(ss.get());
+        ApplicationTools::displayWarning("bppseqgen. Block output is only available for simulations along a single substitution process, and is ignored.");
+        blockSize = 0;
+      }
+
+      if (posteriorSampler)
+        posteriorSampler->outputInternalSequences(mintern);
+      else
+        ss->outputInternalSequences(mintern);
 
+      auto pss=dynamic_cast<SubstitutionProcessSequenceSimulator*>(ss.get());
+
+      // Simulation of sites given their rates and/or root states
+      auto simulateGivenSites = [&](const vector<double>& vRates, const vector<size_t>& vStates) -> std::shared_ptr<SiteContainerInterface>
+      {
         if (withStates)
           if (withRates)
-            sites = pss?pss->simulate(rates, states):SequenceSimulationTools::simulateSites(*ss, rates, states);
+            return pss?pss->simulate(vRates, vStates):SequenceSimulationTools::simulateSites(*ss, vRates, vStates);
           else
-            sites = pss?pss->simulate(states):SequenceSimulationTools::simulateSites(*ss, states);
+            return pss?pss->simulate(vStates):SequenceSimulationTools::simulateSites(*ss, vStates);
         else
-          sites = pss?pss->simulate(rates):SequenceSimulationTools::simulateSites(*ss, rates);
+          return pss?pss->simulate(vRates):SequenceSimulationTools::simulateSites(*ss, vRates);
+      };
+
+      if (blockSize > 0)
+      {
+        // Sites are simulated and written block by block, so that the
+        // whole alignment is never held in memory.
+        string formatName;
+        map<string, string> formatArgs;
+        KeyvalTools::parseProcedure(mformats, formatName, formatArgs);
+        if (formatName != "Fasta")
+          throw Exception("bppseqgen. Block output is only available with Fasta format, not " + formatName + ".");
+        unsigned int charsByLine = ApplicationTools::getParameter<unsigned int>("length", formatArgs, 100, "", true, 1);
+
+        size_t totalSites = withStates ? states.size() : (withRates ? rates.size() : nbSites);
+        size_t nbBlocks = (totalSites + blockSize - 1) / blockSize;
+        ApplicationTools::displayResult(" Sites per block", blockSize);
+
+        BlockAlignmentWriter blockWriter(mfnames, charsByLine);
+
+        ApplicationTools::displayMessage("");
+        ApplicationTools::displayTask("Perform simulations", true);
+        for (size_t b = 0; b < nbBlocks; ++b)
+        {
+          ApplicationTools::displayGauge(b, nbBlocks - 1, '=');
+          size_t first = b * blockSize;
+          size_t last = min(first + blockSize, totalSites);
+          std::shared_ptr<SiteContainerInterface> block;
+          if (withStates || withRates)
+          {
+            vector<double> blockRates;
+            vector<size_t> blockStates;
+            if (withRates)
+              blockRates.assign(rates.begin() + static_cast<ptrdiff_t>(first), rates.begin() + static_cast<ptrdiff_t>(last));
+            if (withStates)
+              blockStates.assign(states.begin() + static_cast<ptrdiff_t>(first), states.begin() + static_cast<ptrdiff_t>(last));
+            block = simulateGivenSites(blockRates, blockStates);
+          }
+          else
+            block = ss->simulate(last - first);
+          
+          blockWriter.appendBlock(*block);
+        }
+        ApplicationTools::displayTaskDone();
+        
+        ApplicationTools::displayTask("Write alignment");
+        blockWriter.close();
+        ApplicationTools::displayTaskDone();
+        ApplicationTools::displayMessage("");
+        continue;
+      }
+      
+      std::shared_ptr<SiteContainerInterface> sites = 0;
+      
+      if (withStates || withRates)
+      {
+        sites = simulateGivenSites(rates, states);
         
         ApplicationTools::displayTaskDone();
       }
@@ -429,11 +577,23 @@ int main(int args, char ** argv)
         ApplicationTools::displayMessage("");
         ApplicationTools::displayTask("Perform simulations");
 
-        sites = ss->simulate(nbSites);
+        if (posteriorSampler)
+          sites = posteriorSampler->simulate(nbSites, nbThreads);
+        else
+          sites = ss->simulate(nbSites);
         ApplicationTools::displayTaskDone();
         ApplicationTools::displayMessage("");
       }
 
+      string outputFormatName;
+      map<string, string> outputFormatArgs;
+      KeyvalTools::parseProcedure(mformats, outputFormatName, outputFormatArgs);
+      if (outputFormatName == PackedAlignment::FORMAT_NAME)
+      {
+        PackedAlignment().writeAlignment(mfnames, *sites, true);
+        continue;
+      }
+      
       unique_ptr<OAlignment> oAln(bppoWriter.read(mformats));
       // ApplicationTools::displayResult("Output alignment file ", filenames[it.first]);
       // ApplicationTools::displayResult("Output alignment format ", oAln->getFormatName());
@@ -65,6 +65,8 @@ using namespace std;
 #include <Bpp/Phyl/Tree/Tree.h>
 #include <Bpp/Phyl/App/PhylogeneticsApplicationTools.h>
 
+#include "PackedAlignment.h"
+
 using namespace bpp;
 
 void help()
@@ -106,7 +108,7 @@ int main(int args, char** argv)
   shared_ptr<SequenceContainerInterface> sequences = 0;
 
   if (aligned) {
-    shared_ptr<VectorSiteContainer> allSites = SequenceApplicationTools::getSiteContainer(alphabet, bppseqman.getParams());
+    shared_ptr<VectorSiteContainer> allSites = PackedAlignment::getSiteContainer(alphabet, bppseqman.getParams());
     sequences = SequenceApplicationTools::getSitesToAnalyse(*allSites, bppseqman.getParams(), "", true, false);
   } else {
     sequences = SequenceApplicationTools::getSequenceContainer(alphabet, bppseqman.getParams(), "", true, true);
@@ -37,8 +37,10 @@ knowledge of the CeCILL license and that you accept its terms.
 */
 
 // From the STL:
+#include <fstream>
 #include <iostream>
 #include <iomanip>
+#include <memory>
 
 using namespace std;
 
@@ -59,6 +61,9 @@ using namespace std;
 #include <Bpp/Phyl/Graphics/CladogramPlot.h>
 #include <Bpp/Phyl/Graphics/TreeDrawingDisplayControler.h>
 
+#include "NewickTreeReader.h"
+#include "ParallelTools.h"
+
 using namespace bpp;
 
 /******************************************************************************/
@@ -73,6 +78,124 @@ void help()
   (*ApplicationTools::message << "__________________________________________________________________________").endLine();
 }
 
+/******************************************************************************/
+
+unique_ptr<GraphicDevice> createGraphicDevice(const string& graphicType, ostream& out)
+{
+  unique_ptr<GraphicDevice> gd = 0;
+  if (graphicType == "Svg")
+  {
+    gd = make_unique<SvgGraphicDevice>(out);
+  }
+  else if (graphicType == "Inkscape")
+  {
+    gd = make_unique<SvgGraphicDevice>(out, true);
+  }
+  else if (graphicType == "Xfig")
+  {
+    gd = make_unique<XFigGraphicDevice>(out);
+    dynamic_cast<XFigGraphicDevice *>(gd.get())->setFontFlag(XFigGraphicDevice::FONTFLAG_POSTSCRIPT);
+  }
+  else if (graphicType == "Pgf")
+  {
+    gd = make_unique<PgfGraphicDevice>(out, 0.045);
+  }
+  else throw Exception("Unknown output format: " + graphicType);
+  return gd;
+}
+
+/******************************************************************************/
+
+/**
+ * @brief A tree plotter with its display settings.
+ *
+ * In batch mode, each worker has its own plotter, and a graphic device is
+ * created for each output file.
+ */
+class TreePlotter
+{
+public:
+  unique_ptr<TreeDrawing> td;
+  TreeDrawingSettings tds;
+  unique_ptr<BasicTreeDrawingDisplayControler> controler;
+
+public:
+  TreePlotter(const string& plotType, const map<string, string>& plotTypeArgs) :
+    td(), tds(), controler()
+  {
+    if (plotType == "Cladogram")
+    {
+      td = make_unique<CladogramPlot>();
+    }
+    else if (plotType == "Phylogram")
+    {
+      td = make_unique<PhylogramPlot>();
+    }
+    else throw Exception("Unknown output format: " + plotType);
+    td->setXUnit(ApplicationTools::getDoubleParameter("xu", plotTypeArgs, 10, "", false, 0));
+    td->setYUnit(ApplicationTools::getDoubleParameter("yu", plotTypeArgs, 10, "", false, 0));
+    string hOrientation = ApplicationTools::getStringParameter("direction.h", plotTypeArgs, "left2right", "", false, 0);
+    if (hOrientation == "left2right")
+    {
+      dynamic_cast<AbstractDendrogramPlot*>(td.get())->setHorizontalOrientation(AbstractDendrogramPlot::ORIENTATION_LEFT_TO_RIGHT);
+    }
+    else if (hOrientation == "right2left")
+    {
+      dynamic_cast<AbstractDendrogramPlot*>(td.get())->setHorizontalOrientation(AbstractDendrogramPlot::ORIENTATION_RIGHT_TO_LEFT);
+    }
+    else throw Exception("Unknown orientation option: " + hOrientation);
+    string vOrientation = ApplicationTools::getStringParameter("direction.v", plotTypeArgs, "top2bottom", "", false, 0);
+    if (vOrientation == "top2bottom")
+    {
+      dynamic_cast<AbstractDendrogramPlot*>(td.get())->setVerticalOrientation(AbstractDendrogramPlot::ORIENTATION_TOP_TO_BOTTOM);
+    }
+    else if (vOrientation == "bottom2top")
+    {
+      dynamic_cast<AbstractDendrogramPlot*>(td.get())->setVerticalOrientation(AbstractDendrogramPlot::ORIENTATION_BOTTOM_TO_TOP);
+    }
+    else throw Exception("Unknown orientation option: " + vOrientation);
+
+    //Plotting option:
+    controler = make_unique<BasicTreeDrawingDisplayControler>(&tds);
+    controler->registerTreeDrawing(td.get());
+    controler->enableListener(controler->PROPERTY_LEAF_NAMES,       ApplicationTools::getBooleanParameter("draw.leaves", plotTypeArgs, true, "", false, 0));
+    controler->enableListener(controler->PROPERTY_NODE_IDS,         ApplicationTools::getBooleanParameter("draw.ids"   , plotTypeArgs, false, "", false, 0));
+    controler->enableListener(controler->PROPERTY_BRANCH_LENGTHS,   ApplicationTools::getBooleanParameter("draw.brlen" , plotTypeArgs, false, "", false, 0));
+    controler->enableListener(controler->PROPERTY_BOOTSTRAP_VALUES, ApplicationTools::getBooleanParameter("draw.bs"    , plotTypeArgs, false, "", false, 0));
+  }
+
+  TreePlotter(const TreePlotter&) = delete;
+  TreePlotter& operator=(const TreePlotter&) = delete;
+
+public:
+  void plot(const Tree& tree, const string& graphicType, const string& outputPath)
+  {
+    ofstream file(outputPath.c_str(), ios::out);
+    if (!file)
+      throw IOException("Could not open output file " + outputPath + ".");
+    unique_ptr<GraphicDevice> gd = createGraphicDevice(graphicType, file);
+    td->setTree(&tree);
+    gd->begin();
+    td->plot(*gd);
+    gd->end();
+    file.close();
+  }
+};
+
+/******************************************************************************/
+
+/**
+ * @brief Insert the number of a tree before the extension of a path.
+ */
+string getNumberedPath(const string& path, size_t number)
+{
+  size_t slash = path.find_last_of("/\\");
+  size_t dot = path.find_last_of('.');
+  if (dot == string::npos || (slash != string::npos && dot < slash))
+    dot = path.size();
+  return path.substr(0, dot) + "_" + TextTools::toString(number) + path.substr(dot);
+}
+
 int main(int args, char ** argv)
 {
   cout << "******************************************************************" << endl;
@@ -93,106 +216,74 @@ int main(int args, char ** argv)
   BppApplication bpptreedraw(args, argv, "BppTreeDraw");
   bpptreedraw.startTimer();
 
-  // Get the tree to plot:
-  auto tree = PhylogeneticsApplicationTools::getTree(bpptreedraw.getParams());
-  ApplicationTools::displayResult("Number of leaves", TextTools::toString(tree->getNumberOfLeaves()));
-  
-  // Get the graphic device:
-  unique_ptr<GraphicDevice> gd = 0;
-	string outputPath = ApplicationTools::getAFilePath("output.drawing.file", bpptreedraw.getParams(), true, false, "", false);
-  ofstream file(outputPath.c_str(), ios::out);
+  // In batch mode, all the trees of a Newick file are drawn, each in its
+  // own numbered file:
+  string treesPath = ApplicationTools::getAFilePath("input.trees.file", bpptreedraw.getParams(), false, true, "", true, "none", 1);
+  bool batch = (treesPath != "none");
+
+  string outputPath = ApplicationTools::getAFilePath("output.drawing.file", bpptreedraw.getParams(), true, false, "", false);
   string graphicTypeCmd = ApplicationTools::getStringParameter("output.drawing.format", bpptreedraw.getParams(), "Svg");
   string graphicType;
   map<string, string> graphicTypeArgs;
   KeyvalTools::parseProcedure(graphicTypeCmd, graphicType, graphicTypeArgs);
-  if (graphicType == "Svg")
-  {
-    gd = make_unique<SvgGraphicDevice>(file);
-  }
-  else if (graphicType == "Inkscape")
-  {
-    gd = make_unique<SvgGraphicDevice>(file, true);
-  }
-  else if (graphicType == "Xfig")
-  {
-    gd = make_unique<XFigGraphicDevice>(file);
-    dynamic_cast<XFigGraphicDevice *>(gd.get())->setFontFlag(XFigGraphicDevice::FONTFLAG_POSTSCRIPT);
-  }
-  else if (graphicType == "Pgf")
-  {
-    gd = make_unique<PgfGraphicDevice>(file, 0.045);
-  }
-  else throw Exception("Unknown output format: " + graphicType);
+  ApplicationTools::displayResult("Output format", graphicType);
 
   // Get the tree plotter:
-  unique_ptr<TreeDrawing> td = 0;
   string plotTypeCmd = ApplicationTools::getStringParameter("output.drawing.plot", bpptreedraw.getParams(), "Cladogram");
   string plotType;
   map<string, string> plotTypeArgs;
   KeyvalTools::parseProcedure(plotTypeCmd, plotType, plotTypeArgs);
-  if (plotType == "Cladogram")
-  {
-    td = make_unique<CladogramPlot>();
-  }
-  else if (plotType == "Phylogram")
-  {
-    td = make_unique<PhylogramPlot>();
-  }
-  else throw Exception("Unknown output format: " + plotType);
-  td->setTree(tree.release());
   ApplicationTools::displayResult("Plot type", plotType);
-  double xunit = ApplicationTools::getDoubleParameter("xu", plotTypeArgs, 10);
-  double yunit = ApplicationTools::getDoubleParameter("yu", plotTypeArgs, 10);
-  td->setXUnit(xunit);
-  td->setYUnit(yunit);
-  string hOrientation = ApplicationTools::getStringParameter("direction.h", plotTypeArgs, "left2right");
-  if (hOrientation == "left2right")
-  {
-    dynamic_cast<AbstractDendrogramPlot*>(td.get())->setHorizontalOrientation(AbstractDendrogramPlot::ORIENTATION_LEFT_TO_RIGHT);
-  }
-  else if (hOrientation == "right2left")
-  {
-    dynamic_cast<AbstractDendrogramPlot*>(td.get())->setHorizontalOrientation(AbstractDendrogramPlot::ORIENTATION_RIGHT_TO_LEFT);
-  }
-  else throw Exception("Unknown orientation option: " + hOrientation);
-  string vOrientation = ApplicationTools::getStringParameter("direction.v", plotTypeArgs, "top2bottom");
-  if (vOrientation == "top2bottom")
+  size_t nbThreads = batch ? ParallelTools::getNumberOfThreads(bpptreedraw.getParams()) : 1;
+  vector< unique_ptr<TreePlotter> > plotters;
+  for (size_t w = 0; w < nbThreads; ++w)
+    plotters.push_back(make_unique<TreePlotter>(plotType, plotTypeArgs));
+
+  ApplicationTools::displayBooleanResult("Draw leaf names"      , ApplicationTools::getBooleanParameter("draw.leaves", plotTypeArgs, true));
+  ApplicationTools::displayBooleanResult("Draw node ids"        , ApplicationTools::getBooleanParameter("draw.ids"   , plotTypeArgs, false));
+  ApplicationTools::displayBooleanResult("Draw branch lengths"  , ApplicationTools::getBooleanParameter("draw.brlen" , plotTypeArgs, false));
+  ApplicationTools::displayBooleanResult("Draw bootstrap values", ApplicationTools::getBooleanParameter("draw.bs"    , plotTypeArgs, false));
+
+  if (!batch)
   {
-    dynamic_cast<AbstractDendrogramPlot*>(td.get())->setVerticalOrientation(AbstractDendrogramPlot::ORIENTATION_TOP_TO_BOTTOM);
+    // Get the tree to plot:
+    auto tree = PhylogeneticsApplicationTools::getTree(bpptreedraw.getParams());
+    ApplicationTools::displayResult("Number of leaves", TextTools::toString(tree->getNumberOfLeaves()));
+
+    //Now draw the tree:
+    plotters[0]->plot(*tree, graphicType, outputPath);
   }
-  else if (vOrientation == "bottom2top")
+  else
   {
-    dynamic_cast<AbstractDendrogramPlot*>(td.get())->setVerticalOrientation(AbstractDendrogramPlot::ORIENTATION_BOTTOM_TO_TOP);
-  }
-  else throw Exception("Unknown orientation option: " + vOrientation);
- 
-  //Plotting option:
-  TreeDrawingSettings tds;
-  auto controler = make_unique<BasicTreeDrawingDisplayControler>(&tds);
-  controler->registerTreeDrawing(td.get());
-
-  bool drawLeafNames       = ApplicationTools::getBooleanParameter("draw.leaves", plotTypeArgs, true);
-  bool drawNodesId         = ApplicationTools::getBooleanParameter("draw.ids"   , plotTypeArgs, false);
-  bool drawBranchLengths   = ApplicationTools::getBooleanParameter("draw.brlen" , plotTypeArgs, false);
-  bool drawBootstrapValues = ApplicationTools::getBooleanParameter("draw.bs"    , plotTypeArgs, false);
-
-  controler->enableListener(controler->PROPERTY_LEAF_NAMES, drawLeafNames);
-  controler->enableListener(controler->PROPERTY_NODE_IDS, drawNodesId);
-  controler->enableListener(controler->PROPERTY_BRANCH_LENGTHS, drawBranchLengths);
-  controler->enableListener(controler->PROPERTY_BOOTSTRAP_VALUES, drawBootstrapValues);
-  
-  ApplicationTools::displayBooleanResult("Draw leaf names"      , drawLeafNames);
-  ApplicationTools::displayBooleanResult("Draw node ids"        , drawNodesId);
-  ApplicationTools::displayBooleanResult("Draw branch lengths"  , drawBranchLengths);
-  ApplicationTools::displayBooleanResult("Draw bootstrap values", drawBootstrapValues);
-  
-  //Now draw the tree:
-  gd->begin();
-  td->plot(*gd);
-  gd->end();
+    ApplicationTools::displayResult("Input trees file", treesPath);
+    ApplicationTools::displayResult("Output files", getNumberedPath(outputPath, 1) + ", ...");
 
-  //Finishing things:
-  file.close();
+    // Trees are read by batches in the main thread, and drawn by the
+    // workers:
+    ApplicationTools::displayTask("Drawing trees", true);
+    NewickTreeReader reader(treesPath);
+    vector<NewickTreeReader::Description> descriptions(100 * nbThreads);
+    size_t nbDrawn = 0;
+    bool hasMore = true;
+    while (hasMore)
+    {
+      size_t nbInBatch = 0;
+      while (nbInBatch < descriptions.size() && (hasMore = reader.nextDescription(descriptions[nbInBatch])))
+      {
+        nbInBatch++;
+      }
+      ParallelTools::parallelFor(nbInBatch, nbThreads,
+        [&](size_t i, size_t w)
+        {
+          auto tree = NewickTreeReader::parse(descriptions[i]);
+          plotters[w]->plot(*tree, graphicType, getNumberedPath(outputPath, nbDrawn + i + 1));
+        });
+      nbDrawn += nbInBatch;
+      ApplicationTools::displayUnlimitedGauge(nbDrawn);
+    }
+    ApplicationTools::displayTaskDone();
+    ApplicationTools::displayResult("Number of trees drawn", nbDrawn);
+  }
 
   bpptreedraw.done(); 
  